@@ -0,0 +1,26 @@
+#ifndef INCLUDE_ALL_PAIRS_HPP
+#define INCLUDE_ALL_PAIRS_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Measures one-way latency of small messages and bandwidth of large ones between every pair of
+ * nodes. Pairs are measured one at a time while all other nodes wait on a barrier, so that no
+ * two transfers compete for memory bus or network.
+ *
+ * Node 0 prints both matrices and groups pairs by location of the nodes: the same socket, the
+ * same host or different hosts. If output is not empty, the matrices are also written to that
+ * file: as JSON if its name ends with ".json" and as CSV otherwise
+ */
+void measure_all_pairs(const boost::mpi::communicator &world, std::size_t max_size,
+                       std::size_t n_warmup, std::size_t n_messages, const std::string &output);
+
+} // namespace parallel
+
+#endif // INCLUDE_ALL_PAIRS_HPP
@@ -0,0 +1,30 @@
+#ifndef INCLUDE_COLLECTIVE_BENCHMARKS_HPP
+#define INCLUDE_COLLECTIVE_BENCHMARKS_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Sums arrays of n doubles from all nodes into out on node 0 along a binary tree: on each step
+ * every node with odd number among those still active sends its partial sum to its left
+ * neighbour and quits. That is the reduction 01-pi-computing performs on rationals.
+ * out is only written on node 0
+ */
+void tree_reduce(const boost::mpi::communicator &comm, const double *in, int n, double *out);
+
+/*
+ * Times broadcast, reduce, the tree reduction above, gather, all_reduce and all_to_all of arrays
+ * of doubles on communicators of 2, 4, 8, ... nodes and on the whole world. Payloads grow 8 times
+ * from 8 bytes to max_size bytes; for gather and all_to_all that is the size of the block each
+ * node sends to each receiver. The time of an operation is the largest average over all nodes
+ */
+void measure_collectives(const boost::mpi::communicator &world, std::size_t max_size,
+                         std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_COLLECTIVE_BENCHMARKS_HPP
@@ -0,0 +1,30 @@
+#ifndef INCLUDE_OVERLAP_HPP
+#define INCLUDE_OVERLAP_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Nodes 0 and 1 exchange raw byte buffers with isend/irecv. For every payload size (powers of 8
+ * from 1 byte to max_size bytes) the program measures:
+ * - t_comm: post both requests and wait for them;
+ * - t_compute: a calibrated compute loop of compute_mcs microseconds or, if compute_mcs is 0,
+ *   of t_comm;
+ * - t_total: post both requests, run the compute loop, wait for the requests;
+ * - the same as t_total but the compute loop is interrupted by n_tests calls of test() on
+ *   the requests, which lets the MPI library progress messages.
+ *
+ * Overlap is 1 - (t_total - t_compute) / t_comm: 1 means the transfer was completely hidden
+ * behind computations, 0 means nothing was overlapped
+ */
+void measure_overlap(const boost::mpi::communicator &world, std::size_t max_size,
+                     std::size_t n_warmup, std::size_t n_messages,
+                     double compute_mcs, std::size_t n_tests);
+
+} // namespace parallel
+
+#endif // INCLUDE_OVERLAP_HPP
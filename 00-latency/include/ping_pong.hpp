@@ -0,0 +1,59 @@
+#ifndef INCLUDE_PING_PONG_HPP
+#define INCLUDE_PING_PONG_HPP
+
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <ranges>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * The rank with the lesser number sends a message to the peer, the peer echoes it back. Each round
+ * trip is timed individually after n_warmup untimed ones. Returns round trip durations in
+ * nanoseconds on the initiating rank and an empty vector on the echoing one.
+ *
+ * send() and recv() transfer one message to and from the peer
+ */
+template<typename Send, typename Recv>
+std::vector<double> ping_pong(const boost::mpi::communicator &world, int peer,
+                              std::size_t n_warmup, std::size_t n_messages, Send send, Recv recv)
+{
+    std::vector<double> round_trips;
+
+    if (world.rank() < peer)
+    {
+        round_trips.reserve(n_messages);
+
+        for (auto i : std::views::iota(0uz, n_warmup + n_messages))
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            send();
+            recv();
+
+            auto finish = std::chrono::steady_clock::now();
+
+            using ns = std::chrono::duration<double, std::nano>;
+            if (i >= n_warmup)
+                round_trips.push_back(ns{finish - start}.count());
+        }
+    }
+    else
+    {
+        for (auto i : std::views::iota(0uz, n_warmup + n_messages))
+        {
+            recv();
+            send();
+        }
+    }
+
+    return round_trips;
+}
+
+} // namespace parallel
+
+#endif // INCLUDE_PING_PONG_HPP
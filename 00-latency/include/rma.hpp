@@ -0,0 +1,29 @@
+#ifndef INCLUDE_RMA_HPP
+#define INCLUDE_RMA_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Node 0 puts arrays of doubles to a window of node 1, gets them from there or accumulates them
+ * there. Every operation is completed by one of the synchronization methods:
+ * - fence: MPI_Win_fence on both nodes;
+ * - pscw: MPI_Win_start/MPI_Win_complete on node 0 and MPI_Win_post/MPI_Win_wait on node 1;
+ * - lock: node 0 holds a passive target lock and calls MPI_Win_flush after each operation;
+ * - shared: the same as lock but the window is allocated with MPI_Win_allocate_shared. In this
+ *   case node 0 also stores data directly to the memory of node 1 and calls MPI_Win_sync.
+ *   Only measured if nodes 0 and 1 share memory.
+ *
+ * Payloads grow 8 times from 8 bytes to max_size bytes. Node 0 prints the time of an operation
+ * together with its synchronization in the same format as sweep mode
+ */
+void measure_rma(const boost::mpi::communicator &world, std::size_t max_size,
+                 std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_RMA_HPP
@@ -0,0 +1,118 @@
+#ifndef INCLUDE_SPSC_RING_HPP
+#define INCLUDE_SPSC_RING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <vector>
+#include <bit>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace parallel
+{
+
+/*
+ * Lock-free byte ring buffer for exactly one producer and one consumer thread. Positions grow
+ * monotonically and are reduced modulo capacity on access. Each position is written by one thread
+ * only and lives on its own cache line together with that thread's copy of the other position,
+ * so threads only touch the shared line when their copy says the ring is full or empty.
+ *
+ * Messages larger than the capacity are transferred in several chunks
+ */
+class SPSC_Ring final
+{
+public:
+
+    static constexpr std::size_t cache_line = 64;
+
+    explicit SPSC_Ring(std::size_t capacity) : buffer_(capacity), mask_{capacity - 1}
+    {
+        if (!std::has_single_bit(capacity))
+            throw std::invalid_argument{"Capacity of the ring must be a power of 2"};
+    }
+
+    SPSC_Ring(const SPSC_Ring &) = delete;
+    SPSC_Ring &operator=(const SPSC_Ring &) = delete;
+
+    void write(const char *data, std::size_t n)
+    {
+        std::size_t tail = producer_.position.load(std::memory_order_relaxed);
+
+        while (n)
+        {
+            std::size_t free = buffer_.size() - (tail - producer_.other);
+            for (unsigned spins = 0; free == 0; ++spins)
+            {
+                backoff(spins);
+                producer_.other = consumer_.position.load(std::memory_order_acquire);
+                free = buffer_.size() - (tail - producer_.other);
+            }
+
+            const std::size_t offset = tail & mask_;
+            const std::size_t chunk = std::min({n, free, buffer_.size() - offset});
+
+            std::memcpy(buffer_.data() + offset, data, chunk);
+
+            tail += chunk;
+            data += chunk;
+            n -= chunk;
+
+            producer_.position.store(tail, std::memory_order_release);
+        }
+    }
+
+    void read(char *data, std::size_t n)
+    {
+        std::size_t head = consumer_.position.load(std::memory_order_relaxed);
+
+        while (n)
+        {
+            std::size_t available = consumer_.other - head;
+            for (unsigned spins = 0; available == 0; ++spins)
+            {
+                backoff(spins);
+                consumer_.other = producer_.position.load(std::memory_order_acquire);
+                available = consumer_.other - head;
+            }
+
+            const std::size_t offset = head & mask_;
+            const std::size_t chunk = std::min({n, available, buffer_.size() - offset});
+
+            std::memcpy(data, buffer_.data() + offset, chunk);
+
+            head += chunk;
+            data += chunk;
+            n -= chunk;
+
+            consumer_.position.store(head, std::memory_order_release);
+        }
+    }
+
+private:
+
+    // spinning is only cheap while the other thread runs on another core
+    static void backoff(unsigned spins)
+    {
+        constexpr unsigned max_spins = 1u << 12;
+
+        if (spins >= max_spins)
+            std::this_thread::yield();
+    }
+
+    struct alignas(cache_line) Side
+    {
+        std::atomic<std::size_t> position{0};
+        std::size_t other = 0; // the last seen position of the other side
+    };
+
+    Side producer_;
+    Side consumer_;
+    std::vector<char> buffer_;
+    std::size_t mask_;
+};
+
+} // namespace parallel
+
+#endif // INCLUDE_SPSC_RING_HPP
@@ -0,0 +1,91 @@
+#ifndef INCLUDE_STATISTICS_HPP
+#define INCLUDE_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <map>
+
+namespace parallel
+{
+
+/*
+ * All samples are durations in nanoseconds
+ */
+struct Latency_Summary
+{
+    std::size_t count;
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double p999;
+    double max;
+    double mean;
+};
+
+Latency_Summary summarize(std::vector<double> samples);
+
+void print_summary(const Latency_Summary &summary);
+
+/*
+ * Hockney (alpha-beta) model of a point-to-point transfer of n bytes: t(n) = alpha + beta * n,
+ * where alpha is latency in nanoseconds and beta is the time of transferring one byte
+ */
+struct Alpha_Beta_Model
+{
+    double alpha;
+    double beta;
+
+    double operator()(double n) const noexcept { return alpha + beta * n; }
+
+    // bytes per nanosecond are the same as gigabytes per second
+    double bandwidth() const noexcept { return 1 / beta; }
+
+    // the size of a message that achieves half of the asymptotic bandwidth
+    double half_performance_size() const noexcept { return alpha / beta; }
+};
+
+/*
+ * Least squares fit minimizing relative rather than absolute residuals, so that large messages
+ * do not make latency of small ones invisible
+ */
+Alpha_Beta_Model fit_alpha_beta(const std::vector<double> &sizes, const std::vector<double> &times);
+
+/*
+ * Log-linear histogram in the spirit of HdrHistogram: every power-of-two range [2^e; 2^(e+1))
+ * is split into sub_buckets linear buckets, so the relative error of a bucket does not exceed
+ * 1 / sub_buckets regardless of the magnitude of the value
+ */
+class Log_Histogram final
+{
+public:
+
+    static constexpr unsigned sub_bucket_bits = 3;
+    static constexpr std::uint64_t sub_buckets = 1u << sub_bucket_bits;
+
+    Log_Histogram() = default;
+
+    template<typename It>
+    Log_Histogram(It first, It last)
+    {
+        for (; first != last; ++first)
+            add(*first);
+    }
+
+    void add(double ns);
+
+    std::size_t count() const noexcept { return count_; }
+
+    void print() const;
+
+private:
+
+    // lower bound of the bucket -> number of samples in it
+    std::map<std::uint64_t, std::size_t> buckets_;
+    std::size_t count_ = 0;
+};
+
+} // namespace parallel
+
+#endif // INCLUDE_STATISTICS_HPP
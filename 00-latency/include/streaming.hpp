@@ -0,0 +1,25 @@
+#ifndef INCLUDE_STREAMING_HPP
+#define INCLUDE_STREAMING_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Node 0 streams raw byte buffers to node 1 keeping up to W isend requests in flight, node 1 keeps
+ * the same number of irecv requests posted. Completed requests are replaced with new ones as soon
+ * as wait_any() reports them. The stream ends with an acknowledgement from node 1, so the time
+ * includes delivery of the last message.
+ *
+ * W runs over powers of two up to max_window, payloads grow 8 times from 1 byte to max_size
+ * bytes. Node 0 prints message rate and bandwidth for every pair of W and payload size
+ */
+void measure_streaming(const boost::mpi::communicator &world, std::size_t max_window,
+                       std::size_t max_size, std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_STREAMING_HPP
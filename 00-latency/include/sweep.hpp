@@ -0,0 +1,21 @@
+#ifndef INCLUDE_SWEEP_HPP
+#define INCLUDE_SWEEP_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Ping-pong of raw byte buffers between nodes 0 and 1 for every power of two from 1 byte to
+ * max_size. Node 0 prints one-way latency and bandwidth for each size and the parameters of the
+ * alpha-beta model fitted to the medians
+ */
+void measure_sweep(const boost::mpi::communicator &world, std::size_t max_size,
+                   std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_SWEEP_HPP
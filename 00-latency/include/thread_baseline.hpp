@@ -0,0 +1,19 @@
+#ifndef INCLUDE_THREAD_BASELINE_HPP
+#define INCLUDE_THREAD_BASELINE_HPP
+
+#include <cstddef>
+
+namespace parallel
+{
+
+/*
+ * Ping-pong and streaming between two threads of the calling process through a pair of
+ * SPSC_Ring. The threads are pinned to the first two CPUs the process is allowed to run on.
+ * Payloads are the same as in sweep mode: every power of two from 1 byte to max_size bytes.
+ * Prints one-way latency (half of round trip) and bandwidth of one-way streaming for each size
+ */
+void measure_thread_baseline(std::size_t max_size, std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_THREAD_BASELINE_HPP
@@ -0,0 +1,23 @@
+#ifndef INCLUDE_THREAD_MULTIPLE_HPP
+#define INCLUDE_THREAD_MULTIPLE_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Nodes 0 and 1 start T threads each, and thread i of node 0 runs ping-pong of 8-byte messages
+ * with thread i of node 1. Threads are told apart either by tags of one communicator or by
+ * separate duplicates of it. T runs over powers of two up to max_threads.
+ *
+ * Requires MPI_THREAD_MULTIPLE. If the MPI library grants a lower level, only T = 1 is measured
+ */
+void measure_thread_multiple(const boost::mpi::communicator &world, std::size_t max_threads,
+                             std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_THREAD_MULTIPLE_HPP
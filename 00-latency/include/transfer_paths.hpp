@@ -0,0 +1,26 @@
+#ifndef INCLUDE_TRANSFER_PATHS_HPP
+#define INCLUDE_TRANSFER_PATHS_HPP
+
+#include <cstddef>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parallel
+{
+
+/*
+ * Ping-pong of std::vector<double> between nodes 0 and 1 through different Boost.MPI paths:
+ * - serialized: send(dest, tag, const std::vector<double> &);
+ * - raw: send(dest, tag, const double *, n) with the MPI datatype of double;
+ * - skeleton: the skeleton of the vector is sent once, then only its content is sent;
+ * - packed: the vector is explicitly written to packed_oarchive which is sent.
+ *
+ * Payloads grow 16 times from 1 element to max_size bytes. Node 0 prints wall and CPU time of
+ * a round trip for each pair of a path and a payload size
+ */
+void measure_transfer_paths(const boost::mpi::communicator &world, std::size_t max_size,
+                            std::size_t n_warmup, std::size_t n_messages);
+
+} // namespace parallel
+
+#endif // INCLUDE_TRANSFER_PATHS_HPP
@@ -0,0 +1,38 @@
+#ifndef INCLUDE_WORK_HPP
+#define INCLUDE_WORK_HPP
+
+#include <cstddef>
+#include <chrono>
+
+namespace parallel
+{
+
+// a chain of dependent floating point operations the compiler cannot drop
+inline double compute(std::size_t n_iterations)
+{
+    volatile double sink = 1.0;
+    double x = sink;
+
+    for (auto i = 0uz; i != n_iterations; ++i)
+        x = x * 0.999999 + 1e-7;
+
+    sink = x;
+    return sink;
+}
+
+inline double iterations_per_mcs()
+{
+    constexpr std::size_t n_iterations = 1uz << 24;
+
+    compute(n_iterations);
+
+    auto start = std::chrono::steady_clock::now();
+    compute(n_iterations);
+    auto finish = std::chrono::steady_clock::now();
+
+    return n_iterations / std::chrono::duration<double, std::micro>(finish - start).count();
+}
+
+} // namespace parallel
+
+#endif // INCLUDE_WORK_HPP
@@ -0,0 +1,263 @@
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <format>
+#include <print>
+
+#include <sched.h>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/collectives.hpp>
+
+#include "all_pairs.hpp"
+#include "ping_pong.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t latency_size = 8;
+static constexpr std::size_t bandwidth_size = 1uz << 20;
+static constexpr std::size_t bytes_per_pair = 1uz << 26;
+static constexpr std::size_t min_messages = 5;
+
+struct Location
+{
+    std::string host;
+    int cpu;
+    int socket;
+};
+
+enum class Distance
+{
+    same_socket,
+    same_host,
+    remote
+};
+
+static constexpr std::array<std::string_view, 3> distance_names{"same socket", "same host",
+                                                                "remote"};
+
+static int socket_of(int cpu)
+{
+    std::ifstream file{"/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                       "/topology/physical_package_id"};
+
+    int socket = -1;
+    file >> socket;
+
+    return socket;
+}
+
+static std::vector<Location> gather_locations(const boost::mpi::communicator &world)
+{
+    const int cpu = sched_getcpu();
+
+    std::vector<std::string> hosts;
+    std::vector<int> cpus, sockets;
+
+    boost::mpi::gather(world, boost::mpi::environment::processor_name(), hosts, 0);
+    boost::mpi::gather(world, cpu, cpus, 0);
+    boost::mpi::gather(world, socket_of(cpu), sockets, 0);
+
+    std::vector<Location> locations;
+    for (auto i = 0uz; i != hosts.size(); ++i)
+        locations.emplace_back(hosts[i], cpus[i], sockets[i]);
+
+    return locations;
+}
+
+static Distance distance(const Location &lhs, const Location &rhs)
+{
+    if (lhs.host != rhs.host)
+        return Distance::remote;
+    else if (lhs.socket != rhs.socket || lhs.socket == -1)
+        return Distance::same_host;
+    else
+        return Distance::same_socket;
+}
+
+// median one-way time of a message of the given size in nanoseconds
+static double one_way_time(const boost::mpi::communicator &world, int peer, std::size_t size,
+                           std::size_t n_warmup, std::size_t n_messages)
+{
+    constexpr int tag = 0;
+
+    std::vector<char> buffer(size);
+    const int count = static_cast<int>(size);
+
+    auto round_trips = ping_pong(world, peer, n_warmup, n_messages,
+                                 [&]{ world.send(peer, tag, buffer.data(), count); },
+                                 [&]{ world.recv(peer, tag, buffer.data(), count); });
+
+    return round_trips.empty() ? 0.0 : summarize(std::move(round_trips)).median / 2;
+}
+
+static void print_matrix(std::string_view title, const std::vector<double> &matrix, int size)
+{
+    std::println("{}:", title);
+
+    std::print("{:>6}", "");
+    for (auto j = 0; j != size; ++j)
+        std::print(" {:>9}", j);
+    std::println();
+
+    for (auto i = 0; i != size; ++i)
+    {
+        std::print("{:>6}", i);
+        for (auto j = 0; j != size; ++j)
+            std::print(" {:>9.3f}", matrix[i * size + j]);
+        std::println();
+    }
+}
+
+static void write_csv(std::ofstream &out, const std::vector<Location> &locations,
+                      const std::vector<double> &latency, const std::vector<double> &bandwidth)
+{
+    const auto size = locations.size();
+
+    std::println(out, "from,to,from_host,to_host,from_cpu,to_cpu,distance,"
+                      "latency_mcs,bandwidth_GBps");
+
+    for (auto i = 0uz; i != size; ++i)
+        for (auto j = 0uz; j != size; ++j)
+            if (i != j)
+                std::println(out, "{},{},{},{},{},{},{},{:.3f},{:.3f}",
+                             i, j, locations[i].host, locations[j].host,
+                             locations[i].cpu, locations[j].cpu,
+                             distance_names[std::to_underlying(distance(locations[i],
+                                                                        locations[j]))],
+                             latency[i * size + j], bandwidth[i * size + j]);
+}
+
+static void write_json(std::ofstream &out, const std::vector<Location> &locations,
+                       const std::vector<double> &latency, const std::vector<double> &bandwidth)
+{
+    const auto size = locations.size();
+
+    auto write_matrix = [&](std::string_view name, const std::vector<double> &matrix)
+    {
+        std::println(out, "  \"{}\": [", name);
+        for (auto i = 0uz; i != size; ++i)
+        {
+            std::print(out, "    [");
+            for (auto j = 0uz; j != size; ++j)
+                std::print(out, "{}{:.3f}", j ? ", " : "", matrix[i * size + j]);
+            std::println(out, "]{}", i + 1 != size ? "," : "");
+        }
+        std::print(out, "  ]");
+    };
+
+    std::println(out, "{{");
+    std::println(out, "  \"ranks\": [");
+    for (auto i = 0uz; i != size; ++i)
+        std::println(out, "    {{\"rank\": {}, \"host\": \"{}\", \"cpu\": {}, \"socket\": {}}}{}",
+                     i, locations[i].host, locations[i].cpu, locations[i].socket,
+                     i + 1 != size ? "," : "");
+    std::println(out, "  ],");
+    write_matrix("latency_mcs", latency);
+    std::println(out, ",");
+    write_matrix("bandwidth_GBps", bandwidth);
+    std::println(out, "\n}}");
+}
+
+void measure_all_pairs(const boost::mpi::communicator &world, std::size_t max_size,
+                       std::size_t n_warmup, std::size_t n_messages, const std::string &output)
+{
+    const int size = world.size();
+    const int rank = world.rank();
+
+    const std::size_t big_size = std::min(bandwidth_size, max_size);
+    const std::size_t n_big =
+        std::max(min_messages, std::min(n_messages, bytes_per_pair / big_size));
+
+    auto locations = gather_locations(world);
+
+    // each pair is measured by the node with the lesser rank, other elements stay zero
+    std::vector<double> local_latency(size * size), local_bandwidth(size * size);
+
+    for (auto i = 0; i != size; ++i)
+        for (auto j = i + 1; j != size; ++j)
+        {
+            world.barrier();
+
+            if (rank != i && rank != j)
+                continue;
+
+            const int peer = (rank == i) ? j : i;
+
+            const double latency = one_way_time(world, peer, latency_size, n_warmup, n_messages);
+            const double big_time =
+                one_way_time(world, peer, big_size, std::min(n_warmup, n_big), n_big);
+
+            if (rank == i)
+            {
+                local_latency[i * size + j] = local_latency[j * size + i] = latency / 1e3;
+                local_bandwidth[i * size + j] = local_bandwidth[j * size + i] = big_size / big_time;
+            }
+        }
+
+    std::vector<double> latency(size * size), bandwidth(size * size);
+    boost::mpi::reduce(world, local_latency.data(), size * size, latency.data(),
+                       std::plus<double>{}, 0);
+    boost::mpi::reduce(world, local_bandwidth.data(), size * size, bandwidth.data(),
+                       std::plus<double>{}, 0);
+
+    if (rank != 0)
+        return;
+
+    std::println("Locations of nodes:");
+    for (auto i = 0; i != size; ++i)
+        std::println("{:>6}: host {}, cpu {}, socket {}",
+                     i, locations[i].host, locations[i].cpu, locations[i].socket);
+    std::println();
+
+    print_matrix(std::format("One-way latency of {} B messages, mcs", latency_size),
+                 latency, size);
+    std::println();
+    print_matrix(std::format("Bandwidth for {} B messages, GB/s", big_size), bandwidth, size);
+
+    std::array<std::vector<double>, 3> latency_by_distance, bandwidth_by_distance;
+    for (auto i = 0; i != size; ++i)
+        for (auto j = i + 1; j != size; ++j)
+        {
+            const auto d = std::to_underlying(distance(locations[i], locations[j]));
+            latency_by_distance[d].push_back(latency[i * size + j]);
+            bandwidth_by_distance[d].push_back(bandwidth[i * size + j]);
+        }
+
+    std::println("\n{:>12} {:>8} {:>14} {:>14} {:>14} {:>14}", "distance", "pairs",
+                 "min latency", "max latency", "min GB/s", "max GB/s");
+    for (auto d = 0uz; d != distance_names.size(); ++d)
+    {
+        if (latency_by_distance[d].empty())
+            continue;
+
+        auto [min_l, max_l] = std::ranges::minmax(latency_by_distance[d]);
+        auto [min_b, max_b] = std::ranges::minmax(bandwidth_by_distance[d]);
+
+        std::println("{:>12} {:>8} {:>14.3f} {:>14.3f} {:>14.3f} {:>14.3f}", distance_names[d],
+                     latency_by_distance[d].size(), min_l, max_l, min_b, max_b);
+    }
+
+    if (output.empty())
+        return;
+
+    std::ofstream out{output};
+    if (!out.is_open())
+        throw std::runtime_error{"Could not open file " + output};
+
+    if (output.ends_with(".json"))
+        write_json(out, locations, latency, bandwidth);
+    else
+        write_csv(out, locations, latency, bandwidth);
+}
+
+} // namespace parallel
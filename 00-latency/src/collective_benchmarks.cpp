@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <ranges>
+#include <print>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include "collective_benchmarks.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 28;
+static constexpr std::size_t min_messages = 5;
+
+void tree_reduce(const boost::mpi::communicator &comm, const double *in, int n, double *out)
+{
+    constexpr int tag = 0;
+
+    const int rank = comm.rank();
+
+    std::vector<double> sum(in, in + n);
+    std::vector<double> another_sum(n);
+
+    unsigned current_size = comm.size();
+    unsigned current_rank = rank;
+    for (int shift = 1; current_size > 1; shift *= 2)
+    {
+        if (current_rank % 2)
+        {
+            comm.send(rank - shift, tag, sum.data(), n);
+            return;
+        }
+        else if (current_rank < current_size - 1)
+        {
+            comm.recv(rank + shift, tag, another_sum.data(), n);
+            std::ranges::transform(sum, another_sum, sum.begin(), std::plus<double>{});
+        }
+
+        std::div_t res = std::div(current_size, 2);
+        current_size = res.rem ? 1 + res.quot : res.quot;
+        current_rank /= 2;
+    }
+
+    std::ranges::copy(sum, out);
+}
+
+/*
+ * Runs op() n_warmup + n_messages times and prints the largest over all nodes average time of
+ * the timed calls
+ */
+template<typename Op>
+static void run_collective(const boost::mpi::communicator &comm, std::string_view name,
+                           std::size_t size, std::size_t n_warmup, std::size_t n_messages, Op op)
+{
+    for (auto i : std::views::iota(0uz, n_warmup))
+        op();
+
+    comm.barrier();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto i : std::views::iota(0uz, n_messages))
+        op();
+
+    auto finish = std::chrono::steady_clock::now();
+
+    const double average = std::chrono::duration<double, std::micro>(finish - start).count()
+                         / n_messages;
+
+    double slowest;
+    boost::mpi::reduce(comm, average, slowest, boost::mpi::maximum<double>{}, 0);
+
+    if (comm.rank() == 0)
+        std::println("{:>14} {:>8} {:>12} {:>10} {:>14.3f}",
+                     name, comm.size(), size, n_messages, slowest);
+}
+
+static void measure_on(const boost::mpi::communicator &comm, std::size_t max_size,
+                       std::size_t n_warmup, std::size_t n_messages)
+{
+    const int n_procs = comm.size();
+
+    for (auto size = sizeof(double); size <= max_size; size *= 8)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+        const std::size_t n_warm = std::min(n_warmup, n);
+        const int count = static_cast<int>(size / sizeof(double));
+
+        std::vector<double> in(count * n_procs, 1.0);
+        std::vector<double> out(count * n_procs);
+
+        run_collective(comm, "broadcast", size, n_warm, n,
+                       [&]{ boost::mpi::broadcast(comm, in.data(), count, 0); });
+
+        run_collective(comm, "reduce", size, n_warm, n, [&]
+        {
+            boost::mpi::reduce(comm, in.data(), count, out.data(), std::plus<double>{}, 0);
+        });
+
+        run_collective(comm, "tree-reduce", size, n_warm, n,
+                       [&]{ tree_reduce(comm, in.data(), count, out.data()); });
+
+        run_collective(comm, "gather", size, n_warm, n, [&]
+        {
+            if (comm.rank() == 0)
+                boost::mpi::gather(comm, in.data(), count, out.data(), 0);
+            else
+                boost::mpi::gather(comm, in.data(), count, 0);
+        });
+
+        run_collective(comm, "all-reduce", size, n_warm, n, [&]
+        {
+            boost::mpi::all_reduce(comm, in.data(), count, out.data(), std::plus<double>{});
+        });
+
+        run_collective(comm, "all-to-all", size, n_warm, n,
+                       [&]{ boost::mpi::all_to_all(comm, in.data(), count, out.data()); });
+    }
+}
+
+void measure_collectives(const boost::mpi::communicator &world, std::size_t max_size,
+                         std::size_t n_warmup, std::size_t n_messages)
+{
+    if (world.rank() == 0)
+    {
+        std::println("Average time of a collective operation, mcs:");
+        std::println("{:>14} {:>8} {:>12} {:>10} {:>14}",
+                     "operation", "nodes", "size, B", "calls", "time");
+    }
+
+    for (int n_procs = 2; ; n_procs = std::min(2 * n_procs, world.size()))
+    {
+        const bool participates = world.rank() < n_procs;
+        boost::mpi::communicator comm = world.split(participates ? 0 : 1);
+
+        if (participates)
+            measure_on(comm, max_size, n_warmup, n_messages);
+
+        world.barrier();
+
+        if (n_procs == world.size())
+            break;
+    }
+}
+
+} // namespace parallel
@@ -2,6 +2,9 @@
 #include <chrono>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <optional>
+#include <vector>
 #include <print>
 #include <ranges>
 
@@ -9,25 +12,128 @@
 #include <boost/mpi/environment.hpp>
 #include <boost/program_options.hpp>
 
-int main(int argc, char *argv[])
+#include "statistics.hpp"
+#include "ping_pong.hpp"
+#include "sweep.hpp"
+#include "transfer_paths.hpp"
+#include "streaming.hpp"
+#include "all_pairs.hpp"
+#include "collective_benchmarks.hpp"
+#include "rma.hpp"
+#include "thread_baseline.hpp"
+#include "overlap.hpp"
+#include "thread_multiple.hpp"
+
+static void measure_send(const boost::mpi::communicator &world, std::size_t N)
 {
-    namespace po = boost::program_options;
+    constexpr int tag = 0;
 
-    boost::mpi::environment env{argc, argv};
-    boost::mpi::communicator world;
+    if (world.rank() == 0)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
 
-    if (world.size() < 2)
-        throw std::runtime_error{"The number of nodes must be at least 2"};
+        for (auto i : std::views::iota(0uz, N))
+            world.send(1, tag, std::vector{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5});
+
+        auto finish = std::chrono::high_resolution_clock::now();
+
+        using mcs = std::chrono::microseconds;
+        std::println("Sending {} instance of std::vector took {} mcs",
+                     N, std::chrono::duration_cast<mcs>(finish - start).count());
+    }
+    else if (world.rank() == 1)
+    {
+        for (auto i : std::views::iota(0uz, N))
+        {
+            std::vector<int> pi;
+            world.recv(0, tag, pi);
+        }
+    }
+}
+
+static void measure_ping_pong(const boost::mpi::communicator &world,
+                              std::size_t n_warmup, std::size_t N)
+{
+    if (world.rank() > 1)
+        return;
+
+    constexpr int tag = 0;
+    const int peer = 1 - world.rank();
+
+    std::vector<int> pi{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    auto round_trips = parallel::ping_pong(world, peer, n_warmup, N,
+                                           [&]{ world.send(peer, tag, pi); },
+                                           [&]{ world.recv(peer, tag, pi); });
+
+    if (world.rank() == 0)
+    {
+        std::println("Round trip of std::vector between nodes 0 and 1 "
+                     "({} messages after {} warmup ones), mcs:", N, n_warmup);
+        parallel::print_summary(parallel::summarize(round_trips));
+
+        std::println("\nHistogram:");
+        parallel::Log_Histogram{round_trips.begin(), round_trips.end()}.print();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
 
     po::options_description desc{"Allowed options"};
 
     desc.add_options()
         ("help", "Produce help message")
+        ("mode", po::value<std::string>()->default_value("send"),
+         "Choose what to measure:\n"
+         "  - send: time of sending messages from node 0 to node 1;\n"
+         "  - ping-pong: round trip time between nodes 0 and 1;\n"
+         "  - sweep: latency and bandwidth for messages of 1 byte to max-size bytes;\n"
+         "  - paths: round trip time of std::vector<double> sent through different\n"
+         "    Boost.MPI paths for payloads up to max-size bytes;\n"
+         "  - stream: message rate with up to window non-blocking sends in flight;\n"
+         "  - all-pairs: latency and bandwidth between every pair of nodes;\n"
+         "  - collectives: time of collective operations for payloads up to\n"
+         "    max-size bytes;\n"
+         "  - rma: time of one-sided put, get and accumulate from node 0 to node 1;\n"
+         "  - spsc: latency and bandwidth between two threads of node 0 through\n"
+         "    a lock-free ring buffer for the same payloads as sweep;\n"
+         "  - overlap: how much of a non-blocking exchange is hidden behind\n"
+         "    computations;\n"
+         "  - threads: message rate and latency of up to max-threads threads per node\n"
+         "    communicating concurrently")
         ("n-messages", po::value<std::size_t>(),
-         "Set the number of messages to send from node 0 to node 1");
+         "Set the number of messages to send from node 0 to node 1")
+        ("warmup", po::value<std::size_t>()->default_value(100),
+         "Set the number of untimed messages sent before measurements")
+        ("max-size", po::value<std::size_t>()->default_value(64uz << 20),
+         "Set the size of the largest message in bytes")
+        ("window", po::value<std::size_t>()->default_value(64),
+         "Set the maximum number of outstanding requests in stream mode")
+        ("output", po::value<std::string>()->default_value(""),
+         "Set the file to write results of all-pairs mode to (.csv or .json)")
+        ("compute", po::value<double>()->default_value(0.0),
+         "Set the length of the compute loop in overlap mode in mcs (0 means as long as "
+         "the exchange)")
+        ("test-calls", po::value<std::size_t>()->default_value(16),
+         "Set the number of test() calls during the compute loop in overlap mode")
+        ("max-threads", po::value<std::size_t>()->default_value(8),
+         "Set the maximum number of threads per node in threads mode");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    const auto mode = vm["mode"].as<std::string>();
+
+    // the threading level is only requested at initialization of MPI, so options go first
+    std::optional<boost::mpi::environment> env;
+    if (mode == "threads")
+        env.emplace(argc, argv, boost::mpi::threading::multiple);
+    else
+        env.emplace(argc, argv);
+
+    boost::mpi::communicator world;
 
     if (vm.count("help"))
     {
@@ -48,29 +154,53 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    constexpr int tag = 0;
-
-    if (world.rank() == 0)
+    // statistics of an empty sample do not exist
+    if (N == 0)
     {
-        auto start = std::chrono::high_resolution_clock::now();
+        if (world.rank() == 0)
+            std::println("The number of messages must be positive. Abort");
 
-        for (auto i : std::views::iota(0uz, N))
-            world.send(1, tag, std::vector{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5});
+        return 0;
+    }
 
-        auto finish = std::chrono::high_resolution_clock::now();
+    if (mode != "spsc" && world.size() < 2)
+        throw std::runtime_error{"The number of nodes must be at least 2"};
 
-        using mcs = std::chrono::microseconds;
-        std::println("Sending {} instance of std::vector took {} mcs",
-                     N, std::chrono::duration_cast<mcs>(finish - start).count());
-    }
-    else if (world.rank() == 1)
+    const auto n_warmup = vm["warmup"].as<std::size_t>();
+    const auto max_size = vm["max-size"].as<std::size_t>();
+    const auto max_window = vm["window"].as<std::size_t>();
+    const auto output = vm["output"].as<std::string>();
+    const auto compute_mcs = vm["compute"].as<double>();
+    const auto n_tests = vm["test-calls"].as<std::size_t>();
+    const auto max_threads = vm["max-threads"].as<std::size_t>();
+
+    if (mode == "send")
+        measure_send(world, N);
+    else if (mode == "ping-pong")
+        measure_ping_pong(world, n_warmup, N);
+    else if (mode == "sweep")
+        parallel::measure_sweep(world, max_size, n_warmup, N);
+    else if (mode == "paths")
+        parallel::measure_transfer_paths(world, max_size, n_warmup, N);
+    else if (mode == "stream")
+        parallel::measure_streaming(world, max_window, max_size, n_warmup, N);
+    else if (mode == "all-pairs")
+        parallel::measure_all_pairs(world, max_size, n_warmup, N, output);
+    else if (mode == "collectives")
+        parallel::measure_collectives(world, max_size, n_warmup, N);
+    else if (mode == "rma")
+        parallel::measure_rma(world, max_size, n_warmup, N);
+    else if (mode == "spsc")
     {
-        for (auto i : std::views::iota(0uz, N))
-        {
-            std::vector<int> pi;
-            world.recv(0, tag, pi);
-        }
+        if (world.rank() == 0)
+            parallel::measure_thread_baseline(max_size, n_warmup, N);
     }
+    else if (mode == "overlap")
+        parallel::measure_overlap(world, max_size, n_warmup, N, compute_mcs, n_tests);
+    else if (mode == "threads")
+        parallel::measure_thread_multiple(world, max_threads, n_warmup, N);
+    else if (world.rank() == 0)
+        std::println("Unsupported mode. Abort");
 
     return 0;
 }
@@ -0,0 +1,253 @@
+#include <cstddef>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <print>
+
+#include <sched.h>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/collectives.hpp>
+#include <boost/program_options.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "statistics.hpp"
+#include "work.hpp"
+
+/*
+ * Fixed work quantum benchmark: every node repeats the same short computation for the given time
+ * and records how long each repetition took. Any excess over the fastest repetition is time stolen
+ * by the OS, other processes or the hardware
+ */
+
+using ns = std::chrono::duration<double, std::nano>;
+
+static std::vector<double> run_quanta(std::size_t n_iterations, double duration_s)
+{
+    std::vector<double> quanta;
+
+    const auto stop = std::chrono::steady_clock::now() + std::chrono::duration<double>{duration_s};
+    for (auto finish = std::chrono::steady_clock::now(); finish < stop; )
+    {
+        auto start = finish;
+        parallel::compute(n_iterations);
+        finish = std::chrono::steady_clock::now();
+
+        quanta.push_back(ns{finish - start}.count());
+    }
+
+    return quanta;
+}
+
+// the share of time spent over the fastest quantum
+static double noise_share(const std::vector<double> &quanta)
+{
+    const double total = std::accumulate(quanta.begin(), quanta.end(), 0.0);
+    return 1 - quanta.size() * std::ranges::min(quanta) / total;
+}
+
+static void print_profiles(const boost::mpi::communicator &world,
+                           const std::vector<double> &quanta)
+{
+    auto s = parallel::summarize(quanta);
+    std::vector<double> profile{s.min, s.median, s.p99, s.max, noise_share(quanta),
+                                static_cast<double>(s.count), static_cast<double>(sched_getcpu())};
+
+    std::vector<std::string> hosts;
+    std::vector<std::vector<double>> profiles;
+    boost::mpi::gather(world, boost::mpi::environment::processor_name(), hosts, 0);
+    boost::mpi::gather(world, profile, profiles, 0);
+
+    if (world.rank() != 0)
+        return;
+
+    std::println("Duration of work quanta on each node, mcs:");
+    std::println("{:>6} {:>16} {:>6} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8}",
+                 "node", "host", "cpu", "quanta", "min", "median", "p99", "max", "noise");
+
+    for (auto rank = 0uz; rank != profiles.size(); ++rank)
+    {
+        const auto &p = profiles[rank];
+        std::println("{:>6} {:>16} {:>6} {:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>7.3f}%",
+                     rank, hosts[rank], p[6], p[5], p[0] / 1e3, p[1] / 1e3, p[2] / 1e3, p[3] / 1e3,
+                     100 * p[4]);
+    }
+}
+
+/*
+ * All nodes compute a quantum and meet on a barrier n_steps times, as in bulk synchronous codes.
+ * Returns durations of steps on node 0
+ */
+static std::vector<double> run_barrier_steps(const boost::mpi::communicator &world,
+                                             std::size_t n_iterations, std::size_t n_steps)
+{
+    std::vector<double> steps;
+    steps.reserve(n_steps);
+
+    world.barrier();
+
+    for (auto i = 0uz; i != n_steps; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        parallel::compute(n_iterations);
+        world.barrier();
+
+        auto finish = std::chrono::steady_clock::now();
+        steps.push_back(ns{finish - start}.count());
+    }
+
+    return steps;
+}
+
+/*
+ * Nodes form a pipeline as in the parallel transport equation solver: on every step a node waits
+ * for a token from the previous node, computes a quantum and passes the token to the next node.
+ * Returns intervals between consecutive steps finished by the last node
+ */
+static std::vector<double> run_chain_steps(const boost::mpi::communicator &world,
+                                           std::size_t n_iterations, std::size_t n_steps)
+{
+    constexpr int tag = 0;
+
+    const int rank = world.rank();
+    const int last = world.size() - 1;
+
+    std::vector<double> periods;
+    periods.reserve(n_steps);
+
+    world.barrier();
+
+    auto previous = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i != n_steps; ++i)
+    {
+        if (rank != 0)
+            world.recv(rank - 1, tag);
+
+        parallel::compute(n_iterations);
+
+        if (rank != last)
+            world.send(rank + 1, tag);
+        else
+        {
+            auto now = std::chrono::steady_clock::now();
+            periods.push_back(ns{now - previous}.count());
+            previous = now;
+        }
+    }
+
+    return periods;
+}
+
+static void print_amplification(std::string_view name, std::vector<double> steps,
+                                const parallel::Latency_Summary &quantum)
+{
+    auto s = parallel::summarize(std::move(steps));
+
+    std::println("{:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>14.3f} {:>14.3f}",
+                 name, s.min / 1e3, s.median / 1e3, s.p99 / 1e3, s.max / 1e3,
+                 s.mean / quantum.mean, s.p99 / quantum.p99);
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    boost::mpi::environment env{argc, argv};
+    boost::mpi::communicator world;
+
+    po::options_description desc{"Allowed options"};
+
+    desc.add_options()
+        ("help", "Produce help message")
+        ("quantum", po::value<double>()->default_value(10.0),
+         "Set the duration of a work quantum in mcs")
+        ("duration", po::value<double>()->default_value(1.0),
+         "Set the time each measurement lasts in seconds")
+        ("output", po::value<std::string>()->default_value(""),
+         "Set the CSV file to write durations of all quanta to");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        if (world.rank() == 0)
+            std::cout << desc << std::endl;
+
+        return 0;
+    }
+
+    const auto quantum_mcs = vm["quantum"].as<double>();
+    const auto duration_s = vm["duration"].as<double>();
+    const auto output = vm["output"].as<std::string>();
+
+    if (quantum_mcs <= 0 || duration_s <= 0)
+        throw std::invalid_argument{"Duration of a quantum and of measurements must be positive"};
+
+    // all nodes run exactly the same work, so node 0 calibrates it
+    std::size_t n_iterations;
+    if (world.rank() == 0)
+        n_iterations = static_cast<std::size_t>(quantum_mcs * parallel::iterations_per_mcs());
+    boost::mpi::broadcast(world, n_iterations, 0);
+
+    world.barrier();
+    auto quanta = run_quanta(n_iterations, duration_s);
+
+    print_profiles(world, quanta);
+
+    if (!output.empty())
+    {
+        std::vector<std::vector<double>> all_quanta;
+        boost::mpi::gather(world, quanta, all_quanta, 0);
+
+        if (world.rank() == 0)
+        {
+            std::ofstream out{output};
+            if (!out.is_open())
+                throw std::runtime_error{"Could not open file " + output};
+
+            std::println(out, "node,quantum,duration_ns");
+            for (auto rank = 0uz; rank != all_quanta.size(); ++rank)
+                for (auto i = 0uz; i != all_quanta[rank].size(); ++i)
+                    std::println(out, "{},{},{:.0f}", rank, i, all_quanta[rank][i]);
+        }
+    }
+
+    if (world.size() < 2)
+        return 0;
+
+    auto quantum = parallel::summarize(quanta);
+
+    std::size_t n_steps = quanta.size();
+    boost::mpi::broadcast(world, n_steps, 0);
+
+    auto barrier_steps = run_barrier_steps(world, n_iterations, n_steps);
+    auto chain_steps = run_chain_steps(world, n_iterations, n_steps);
+
+    // node 0 knows the barrier steps, the last node knows the chain steps
+    if (world.rank() == world.size() - 1)
+        world.send(0, 0, chain_steps);
+    else if (world.rank() == 0)
+        world.recv(world.size() - 1, 0, chain_steps);
+
+    if (world.rank() != 0)
+        return 0;
+
+    std::println("\nDuration of a step of {} synchronized nodes, mcs "
+                 "(amplification is relative to a single quantum on node 0):", world.size());
+    std::println("{:>10} {:>10} {:>10} {:>10} {:>10} {:>14} {:>14}",
+                 "sync", "min", "median", "p99", "max", "mean ampl.", "p99 ampl.");
+    print_amplification("barrier", std::move(barrier_steps), quantum);
+    print_amplification("chain", std::move(chain_steps), quantum);
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <print>
+
+#include <boost/mpi/request.hpp>
+
+#include "overlap.hpp"
+#include "statistics.hpp"
+#include "work.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+
+template<typename F>
+static double time_mcs(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(finish - start).count();
+}
+
+static double median(std::vector<double> samples)
+{
+    return summarize(std::move(samples)).median;
+}
+
+void measure_overlap(const boost::mpi::communicator &world, std::size_t max_size,
+                     std::size_t n_warmup, std::size_t n_messages,
+                     double compute_mcs, std::size_t n_tests)
+{
+    // the barrier and the exchanges involve nodes 0 and 1 only
+    boost::mpi::communicator pair = world.split(world.rank() < 2 ? 0 : 1);
+    if (world.rank() > 1)
+        return;
+
+    constexpr int tag = 0;
+    const int peer = 1 - pair.rank();
+
+    // both nodes must run compute loops of the same length, so node 0 calibrates it
+    double speed;
+    if (pair.rank() == 0)
+    {
+        speed = iterations_per_mcs();
+        pair.send(peer, tag, speed);
+    }
+    else
+        pair.recv(peer, tag, speed);
+
+    if (pair.rank() == 0)
+    {
+        std::println("Overlap of exchange between nodes 0 and 1 with computations, mcs:");
+        std::println("{:>12} {:>10} {:>10} {:>10} {:>10} {:>9} {:>10} {:>9}",
+                     "size, B", "messages", "comm", "compute", "total", "overlap",
+                     "w/ test", "overlap");
+    }
+
+    for (auto size = 1uz; size <= max_size; size *= 8)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+        const int count = static_cast<int>(size);
+
+        std::vector<char> send_buffer(size), recv_buffer(size);
+        std::array<boost::mpi::request, 2> requests;
+        std::array<bool, 2> completed;
+
+        auto post = [&]
+        {
+            requests[0] = pair.irecv(peer, tag, recv_buffer.data(), count);
+            requests[1] = pair.isend(peer, tag, send_buffer.data(), count);
+            completed.fill(false);
+        };
+
+        // completed requests are not tested again
+        auto test = [&]
+        {
+            for (auto i = 0uz; i != requests.size(); ++i)
+                if (!completed[i])
+                    completed[i] = requests[i].test().has_value();
+        };
+
+        auto wait = [&]
+        {
+            for (auto i = 0uz; i != requests.size(); ++i)
+                if (!completed[i])
+                    requests[i].wait();
+        };
+
+        auto measure = [&](auto exchange)
+        {
+            std::vector<double> samples;
+            for (auto i = 0uz; i != std::min(n_warmup, n) + n; ++i)
+            {
+                pair.barrier();
+                const double t = time_mcs(exchange);
+                if (i >= std::min(n_warmup, n))
+                    samples.push_back(t);
+            }
+
+            // the slower node defines the time of the exchange
+            double t = median(std::move(samples));
+            double peer_t;
+            pair.send(peer, tag, t);
+            pair.recv(peer, tag, peer_t);
+
+            return std::max(t, peer_t);
+        };
+
+        const double t_comm = measure([&]{ post(); wait(); });
+
+        const double t_target = (compute_mcs > 0) ? compute_mcs : t_comm;
+        const auto n_iterations = static_cast<std::size_t>(t_target * speed);
+        const std::size_t slice = n_iterations / std::max(n_tests, 1uz);
+
+        const double t_compute = measure([&]{ compute(n_iterations); });
+
+        const double t_total = measure([&]{ post(); compute(n_iterations); wait(); });
+
+        const double t_total_test = measure([&]
+        {
+            post();
+
+            for (auto i = 0uz; i != n_tests; ++i)
+            {
+                compute(slice);
+                test();
+            }
+            compute(n_iterations - slice * n_tests);
+
+            wait();
+        });
+
+        auto overlap = [&](double t)
+        {
+            return 100 * std::clamp(1 - (t - t_compute) / t_comm, 0.0, 1.0);
+        };
+
+        if (pair.rank() == 0)
+            std::println("{:>12} {:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>8.1f}% "
+                         "{:>10.3f} {:>8.1f}%", size, n, t_comm, t_compute, t_total, overlap(t_total),
+                         t_total_test, overlap(t_total_test));
+    }
+}
+
+} // namespace parallel
@@ -0,0 +1,334 @@
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include <format>
+#include <print>
+
+#include <mpi.h>
+
+#include <boost/mpi/exception.hpp>
+
+#include "rma.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+
+static constexpr int origin = 0;
+static constexpr int target = 1;
+
+class RMA_Window final
+{
+public:
+
+    RMA_Window(MPI_Comm comm, std::size_t size, bool shared)
+    {
+        const auto bytes = static_cast<MPI_Aint>(size);
+
+        if (shared)
+        {
+            BOOST_MPI_CHECK_RESULT(MPI_Win_allocate_shared,
+                                   (bytes, sizeof(double), MPI_INFO_NULL, comm, &base_, &win_));
+        }
+        else
+        {
+            BOOST_MPI_CHECK_RESULT(MPI_Win_allocate,
+                                   (bytes, sizeof(double), MPI_INFO_NULL, comm, &base_, &win_));
+        }
+    }
+
+    RMA_Window(const RMA_Window &) = delete;
+    RMA_Window &operator=(const RMA_Window &) = delete;
+
+    ~RMA_Window() { MPI_Win_free(&win_); }
+
+    MPI_Win get() const noexcept { return win_; }
+
+    // memory of the window of node rank. Only valid for shared windows
+    double *shared_memory_of(int rank) const
+    {
+        MPI_Aint size;
+        int disp_unit;
+        double *memory;
+
+        BOOST_MPI_CHECK_RESULT(MPI_Win_shared_query, (win_, rank, &size, &disp_unit, &memory));
+
+        return memory;
+    }
+
+private:
+
+    double *base_;
+    MPI_Win win_;
+};
+
+enum class Operation
+{
+    put,
+    get,
+    accumulate
+};
+
+static constexpr std::string_view operation_names[] = {"put", "get", "accumulate"};
+
+static void issue(Operation op, double *data, int count, MPI_Win win)
+{
+    switch (op)
+    {
+        case Operation::put:
+            BOOST_MPI_CHECK_RESULT(MPI_Put, (data, count, MPI_DOUBLE, target, 0,
+                                             count, MPI_DOUBLE, win));
+            break;
+
+        case Operation::get:
+            BOOST_MPI_CHECK_RESULT(MPI_Get, (data, count, MPI_DOUBLE, target, 0,
+                                             count, MPI_DOUBLE, win));
+            break;
+
+        case Operation::accumulate:
+            BOOST_MPI_CHECK_RESULT(MPI_Accumulate, (data, count, MPI_DOUBLE, target, 0,
+                                                    count, MPI_DOUBLE, MPI_SUM, win));
+            break;
+
+        default:
+            std::unreachable();
+    }
+}
+
+/*
+ * Calls epoch() n_warmup + n_messages times on both nodes and returns durations of the timed
+ * calls on node 0 in nanoseconds
+ */
+template<typename Epoch>
+static std::vector<double> time_epochs(const boost::mpi::communicator &comm,
+                                       std::size_t n_warmup, std::size_t n_messages, Epoch epoch)
+{
+    std::vector<double> durations;
+    durations.reserve(n_messages);
+
+    for (auto i = 0uz; i != n_warmup + n_messages; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        epoch();
+        auto finish = std::chrono::steady_clock::now();
+
+        using ns = std::chrono::duration<double, std::nano>;
+        if (comm.rank() == origin && i >= n_warmup)
+            durations.push_back(ns{finish - start}.count());
+    }
+
+    return durations;
+}
+
+static std::vector<double> fence(const boost::mpi::communicator &comm, const RMA_Window &window,
+                                 Operation op, std::vector<double> &data, std::size_t n_warmup,
+                                 std::size_t n_messages)
+{
+    const int count = static_cast<int>(data.size());
+    MPI_Win win = window.get();
+
+    BOOST_MPI_CHECK_RESULT(MPI_Win_fence, (MPI_MODE_NOPRECEDE, win));
+
+    auto durations = time_epochs(comm, n_warmup, n_messages, [&]
+    {
+        if (comm.rank() == origin)
+            issue(op, data.data(), count, win);
+
+        BOOST_MPI_CHECK_RESULT(MPI_Win_fence, (0, win));
+    });
+
+    BOOST_MPI_CHECK_RESULT(MPI_Win_fence, (MPI_MODE_NOSUCCEED, win));
+
+    return durations;
+}
+
+static std::vector<double> pscw(const boost::mpi::communicator &comm, const RMA_Window &window,
+                                Operation op, std::vector<double> &data, std::size_t n_warmup,
+                                std::size_t n_messages)
+{
+    const int count = static_cast<int>(data.size());
+    const int peer = 1 - comm.rank();
+    MPI_Win win = window.get();
+
+    MPI_Group comm_group, peer_group;
+    BOOST_MPI_CHECK_RESULT(MPI_Comm_group, (comm, &comm_group));
+    BOOST_MPI_CHECK_RESULT(MPI_Group_incl, (comm_group, 1, &peer, &peer_group));
+
+    auto durations = time_epochs(comm, n_warmup, n_messages, [&]
+    {
+        if (comm.rank() == origin)
+        {
+            BOOST_MPI_CHECK_RESULT(MPI_Win_start, (peer_group, 0, win));
+            issue(op, data.data(), count, win);
+            BOOST_MPI_CHECK_RESULT(MPI_Win_complete, (win));
+        }
+        else
+        {
+            BOOST_MPI_CHECK_RESULT(MPI_Win_post, (peer_group, 0, win));
+            BOOST_MPI_CHECK_RESULT(MPI_Win_wait, (win));
+        }
+    });
+
+    MPI_Group_free(&peer_group);
+    MPI_Group_free(&comm_group);
+
+    return durations;
+}
+
+// the target is passive: it only waits on the barrier until the origin finishes
+static std::vector<double> lock(const boost::mpi::communicator &comm, const RMA_Window &window,
+                                Operation op, std::vector<double> &data, std::size_t n_warmup,
+                                std::size_t n_messages)
+{
+    const int count = static_cast<int>(data.size());
+    MPI_Win win = window.get();
+
+    std::vector<double> durations;
+
+    if (comm.rank() == origin)
+    {
+        BOOST_MPI_CHECK_RESULT(MPI_Win_lock, (MPI_LOCK_SHARED, target, 0, win));
+
+        durations = time_epochs(comm, n_warmup, n_messages, [&]
+        {
+            issue(op, data.data(), count, win);
+            BOOST_MPI_CHECK_RESULT(MPI_Win_flush, (target, win));
+        });
+
+        BOOST_MPI_CHECK_RESULT(MPI_Win_unlock, (target, win));
+    }
+
+    comm.barrier();
+
+    return durations;
+}
+
+// direct stores to the memory of the target made visible with MPI_Win_sync
+static std::vector<double> store(const boost::mpi::communicator &comm, const RMA_Window &window,
+                                 std::vector<double> &data, std::size_t n_warmup,
+                                 std::size_t n_messages)
+{
+    MPI_Win win = window.get();
+    double *target_memory = window.shared_memory_of(target);
+
+    std::vector<double> durations;
+
+    BOOST_MPI_CHECK_RESULT(MPI_Win_lock_all, (MPI_MODE_NOCHECK, win));
+
+    if (comm.rank() == origin)
+    {
+        durations = time_epochs(comm, n_warmup, n_messages, [&]
+        {
+            std::memcpy(target_memory, data.data(), data.size() * sizeof(double));
+            BOOST_MPI_CHECK_RESULT(MPI_Win_sync, (win));
+        });
+    }
+
+    BOOST_MPI_CHECK_RESULT(MPI_Win_unlock_all, (win));
+
+    comm.barrier();
+
+    return durations;
+}
+
+static void print_header(std::string_view title)
+{
+    std::println("\n{}, mcs:", title);
+    std::println("{:>12} {:>10} {:>10} {:>10} {:>10} {:>12}",
+                 "size, B", "messages", "min", "median", "p99", "GB/s");
+}
+
+static void print_row(std::size_t size, std::vector<double> durations)
+{
+    auto s = summarize(std::move(durations));
+
+    std::println("{:>12} {:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>12.3f}",
+                 size, s.count, s.min / 1e3, s.median / 1e3, s.p99 / 1e3, size / s.median);
+}
+
+template<typename Sync>
+static void measure_sync(const boost::mpi::communicator &comm, std::string_view sync_name,
+                         const RMA_Window &window, std::size_t max_size,
+                         std::size_t n_warmup, std::size_t n_messages, Sync sync)
+{
+    for (auto op : {Operation::put, Operation::get, Operation::accumulate})
+    {
+        if (comm.rank() == origin)
+            print_header(std::format("{} with {} synchronization",
+                                     operation_names[std::to_underlying(op)], sync_name));
+
+        for (auto size = sizeof(double); size <= max_size; size *= 8)
+        {
+            const std::size_t n =
+                std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+
+            std::vector<double> data(size / sizeof(double), 1.0);
+            auto durations = sync(comm, window, op, data, std::min(n_warmup, n), n);
+
+            if (comm.rank() == origin)
+                print_row(size, std::move(durations));
+        }
+    }
+}
+
+void measure_rma(const boost::mpi::communicator &world, std::size_t max_size,
+                 std::size_t n_warmup, std::size_t n_messages)
+{
+    boost::mpi::communicator comm = world.split(world.rank() < 2 ? 0 : 1);
+    if (world.rank() > 1)
+        return;
+
+    if (comm.rank() == origin)
+        std::println("One-sided operations from node 0 to node 1 including synchronization:");
+
+    {
+        RMA_Window window{comm, max_size, false};
+
+        measure_sync(comm, "fence", window, max_size, n_warmup, n_messages, fence);
+        measure_sync(comm, "pscw", window, max_size, n_warmup, n_messages, pscw);
+        measure_sync(comm, "lock/flush", window, max_size, n_warmup, n_messages, lock);
+    }
+
+    MPI_Comm node_comm;
+    BOOST_MPI_CHECK_RESULT(MPI_Comm_split_type,
+                           (comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm));
+
+    int node_size;
+    BOOST_MPI_CHECK_RESULT(MPI_Comm_size, (node_comm, &node_size));
+    MPI_Comm_free(&node_comm);
+
+    if (node_size != comm.size())
+    {
+        if (comm.rank() == origin)
+            std::println("\nNodes 0 and 1 do not share memory: shared window is not measured");
+
+        return;
+    }
+
+    RMA_Window window{comm, max_size, true};
+
+    measure_sync(comm, "shared window lock/flush", window, max_size, n_warmup, n_messages, lock);
+
+    if (comm.rank() == origin)
+        print_header("direct store to shared window with MPI_Win_sync");
+
+    for (auto size = sizeof(double); size <= max_size; size *= 8)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+
+        std::vector<double> data(size / sizeof(double), 1.0);
+        auto durations = store(comm, window, data, std::min(n_warmup, n), n);
+
+        if (comm.rank() == origin)
+            print_row(size, std::move(durations));
+    }
+}
+
+} // namespace parallel
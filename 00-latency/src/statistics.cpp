@@ -0,0 +1,117 @@
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <string>
+#include <stdexcept>
+#include <print>
+
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+// nearest-rank percentile of a sorted sample
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp(rank, 1uz, sorted.size()) - 1];
+}
+
+Latency_Summary summarize(std::vector<double> samples)
+{
+    if (samples.empty())
+        throw std::invalid_argument{"Cannot summarize an empty sample"};
+
+    std::ranges::sort(samples);
+
+    return Latency_Summary{
+        .count = samples.size(),
+        .min = samples.front(),
+        .median = percentile(samples, 0.5),
+        .p90 = percentile(samples, 0.9),
+        .p99 = percentile(samples, 0.99),
+        .p999 = percentile(samples, 0.999),
+        .max = samples.back(),
+        .mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size()
+    };
+}
+
+void print_summary(const Latency_Summary &s)
+{
+    constexpr double ns_per_mcs = 1e3;
+
+    std::println("{:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}",
+                 "samples", "min", "median", "p90", "p99", "p99.9", "max", "mean");
+    std::println("{:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}",
+                 s.count, s.min / ns_per_mcs, s.median / ns_per_mcs, s.p90 / ns_per_mcs,
+                 s.p99 / ns_per_mcs, s.p999 / ns_per_mcs, s.max / ns_per_mcs, s.mean / ns_per_mcs);
+}
+
+Alpha_Beta_Model fit_alpha_beta(const std::vector<double> &sizes, const std::vector<double> &times)
+{
+    if (sizes.size() != times.size() || sizes.size() < 2)
+        throw std::invalid_argument{"At least 2 measurements are required to fit the model"};
+
+    double S = 0, S_n = 0, S_t = 0, S_nn = 0, S_nt = 0;
+    for (auto i = 0uz; i != sizes.size(); ++i)
+    {
+        const double n = sizes[i], t = times[i];
+        const double w = 1 / (t * t);
+
+        S += w;
+        S_n += w * n;
+        S_t += w * t;
+        S_nn += w * n * n;
+        S_nt += w * n * t;
+    }
+
+    const double beta = (S * S_nt - S_n * S_t) / (S * S_nn - S_n * S_n);
+    const double alpha = (S_t - beta * S_n) / S;
+
+    return Alpha_Beta_Model{alpha, beta};
+}
+
+void Log_Histogram::add(double ns)
+{
+    auto value = static_cast<std::uint64_t>(std::max(ns, 0.0));
+
+    std::uint64_t lower = value;
+    if (value >= sub_buckets)
+    {
+        const unsigned shift = std::bit_width(value) - 1 - sub_bucket_bits;
+        lower = (value >> shift) << shift;
+    }
+
+    ++buckets_[lower];
+    ++count_;
+}
+
+void Log_Histogram::print() const
+{
+    constexpr std::size_t bar_width = 50;
+
+    std::size_t max_count = 0;
+    for (auto [lower, count] : buckets_)
+        max_count = std::max(max_count, count);
+
+    std::println("{:>12} {:>12} {:>10} {:>8}", "from, ns", "to, ns", "count", "cumul.");
+
+    std::size_t cumulative = 0;
+    for (auto [lower, count] : buckets_)
+    {
+        const std::uint64_t width =
+            (lower < sub_buckets) ? 1 : std::bit_floor(lower) >> sub_bucket_bits;
+
+        cumulative += count;
+
+        std::println("{:>12} {:>12} {:>10} {:>7.3f}% {}",
+                     lower, lower + width, count, 100.0 * cumulative / count_,
+                     std::string(std::max(1uz, bar_width * count / max_count), '#'));
+    }
+}
+
+} // namespace parallel
@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <print>
+
+#include <boost/mpi/request.hpp>
+#include <boost/mpi/nonblocking.hpp>
+
+#include "streaming.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+
+static void stream(const boost::mpi::communicator &world, std::size_t window,
+                   std::vector<std::vector<char>> &buffers, std::size_t n_messages)
+{
+    constexpr int tag = 0;
+    constexpr int ack_tag = 1;
+    const int peer = 1 - world.rank();
+    const int count = static_cast<int>(buffers.front().size());
+
+    auto post = [&](std::size_t slot)
+    {
+        if (world.rank() == 0)
+            // the same buffer may be read by several sends at once
+            return world.isend(peer, tag, buffers.front().data(), count);
+        else
+            return world.irecv(peer, tag, buffers[slot].data(), count);
+    };
+
+    // on node 1 the request i always receives to the buffer i
+    std::vector<boost::mpi::request> requests;
+
+    std::size_t n_posted = 0;
+    for (; n_posted != std::min(window, n_messages); ++n_posted)
+        requests.push_back(post(n_posted));
+
+    for (; n_posted != n_messages; ++n_posted)
+    {
+        auto completed = boost::mpi::wait_any(requests.begin(), requests.end()).second;
+        const auto i = static_cast<std::size_t>(completed - requests.begin());
+
+        requests[i] = post(i);
+    }
+
+    boost::mpi::wait_all(requests.begin(), requests.end());
+
+    if (world.rank() == 0)
+        world.recv(peer, ack_tag);
+    else
+        world.send(peer, ack_tag);
+}
+
+void measure_streaming(const boost::mpi::communicator &world, std::size_t max_window,
+                       std::size_t max_size, std::size_t n_warmup, std::size_t n_messages)
+{
+    if (world.rank() > 1)
+        return;
+
+    if (world.rank() == 0)
+    {
+        std::println("Streaming from node 0 to node 1:");
+        std::println("{:>12} {:>8} {:>10} {:>14} {:>12}",
+                     "size, B", "window", "messages", "messages/s", "GB/s");
+    }
+
+    for (auto size = 1uz; size <= max_size; size *= 8)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+
+        for (auto window = 1uz; window <= max_window; window *= 2)
+        {
+            const std::size_t n_slots = (world.rank() == 0) ? 1 : window;
+            std::vector<std::vector<char>> buffers(n_slots, std::vector<char>(size));
+
+            stream(world, window, buffers, std::min(n_warmup, n));
+
+            auto start = std::chrono::steady_clock::now();
+            stream(world, window, buffers, n);
+            auto finish = std::chrono::steady_clock::now();
+
+            if (world.rank() == 0)
+            {
+                const double ns = std::chrono::duration<double, std::nano>(finish - start).count();
+                std::println("{:>12} {:>8} {:>10} {:>14.0f} {:>12.3f}",
+                             size, window, n, 1e9 * n / ns, n * size / ns);
+            }
+        }
+    }
+}
+
+} // namespace parallel
@@ -0,0 +1,143 @@
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <print>
+
+#include "sweep.hpp"
+#include "ping_pong.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+// no more than this many bytes are sent in one direction for each message size
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+
+static double relative_error(const Alpha_Beta_Model &model,
+                             const std::vector<double> &sizes, const std::vector<double> &times)
+{
+    double error = 0;
+    for (auto i = 0uz; i != sizes.size(); ++i)
+    {
+        const double r = (times[i] - model(sizes[i])) / times[i];
+        error += r * r;
+    }
+
+    return error;
+}
+
+static void print_model(const Alpha_Beta_Model &model)
+{
+    std::println("    alpha = {:.3f} mcs", model.alpha / 1e3);
+    std::println("    bandwidth = {:.3f} GB/s", model.bandwidth());
+    std::println("    half-performance message size = {:.0f} B", model.half_performance_size());
+}
+
+/*
+ * MPI libraries switch from eager to rendezvous protocol at some message size, so latency is
+ * better described by two lines than by one. Tries every split point leaving at least 2 sizes on
+ * each side and prints the pair of models with the least total error
+ */
+static void print_two_regime_model(const std::vector<double> &sizes,
+                                   const std::vector<double> &times)
+{
+    if (sizes.size() < 4)
+        return;
+
+    std::size_t best_split = 0;
+    double best_error = relative_error(fit_alpha_beta(sizes, times), sizes, times);
+
+    for (auto split = 2uz; split + 2 <= sizes.size(); ++split)
+    {
+        std::vector<double> small_sizes(sizes.begin(), sizes.begin() + split);
+        std::vector<double> small_times(times.begin(), times.begin() + split);
+        std::vector<double> large_sizes(sizes.begin() + split, sizes.end());
+        std::vector<double> large_times(times.begin() + split, times.end());
+
+        const double error =
+            relative_error(fit_alpha_beta(small_sizes, small_times), small_sizes, small_times) +
+            relative_error(fit_alpha_beta(large_sizes, large_times), large_sizes, large_times);
+
+        if (error < best_error)
+        {
+            best_error = error;
+            best_split = split;
+        }
+    }
+
+    if (best_split == 0)
+        return;
+
+    std::vector<double> small_sizes(sizes.begin(), sizes.begin() + best_split);
+    std::vector<double> small_times(times.begin(), times.begin() + best_split);
+    std::vector<double> large_sizes(sizes.begin() + best_split, sizes.end());
+    std::vector<double> large_times(times.begin() + best_split, times.end());
+
+    std::println("\nProtocol switch detected between {:.0f} B and {:.0f} B",
+                 sizes[best_split - 1], sizes[best_split]);
+    std::println("Messages up to {:.0f} B:", sizes[best_split - 1]);
+    print_model(fit_alpha_beta(small_sizes, small_times));
+    std::println("Messages from {:.0f} B:", sizes[best_split]);
+    print_model(fit_alpha_beta(large_sizes, large_times));
+}
+
+void measure_sweep(const boost::mpi::communicator &world, std::size_t max_size,
+                   std::size_t n_warmup, std::size_t n_messages)
+{
+    if (world.rank() > 1)
+        return;
+
+    constexpr int tag = 0;
+    const int peer = 1 - world.rank();
+
+    std::vector<char> buffer(max_size);
+    std::vector<double> sizes, latencies;
+
+    if (world.rank() == 0)
+    {
+        std::println("One-way latency between nodes 0 and 1 (half of round trip), mcs:");
+        std::println("{:>12} {:>10} {:>10} {:>10} {:>10} {:>12}",
+                     "size, B", "messages", "min", "median", "p99", "GB/s");
+    }
+
+    for (auto size = 1uz; size <= max_size; size *= 2)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+        const int count = static_cast<int>(size);
+
+        auto round_trips = ping_pong(world, peer, std::min(n_warmup, n), n,
+                                     [&]{ world.send(peer, tag, buffer.data(), count); },
+                                     [&]{ world.recv(peer, tag, buffer.data(), count); });
+
+        if (world.rank() != 0)
+            continue;
+
+        auto s = summarize(std::move(round_trips));
+        const double one_way = s.median / 2;
+
+        sizes.push_back(size);
+        latencies.push_back(one_way);
+
+        std::println("{:>12} {:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>12.3f}",
+                     size, n, s.min / 2e3, one_way / 1e3, s.p99 / 2e3, size / one_way);
+    }
+
+    if (world.rank() != 0 || sizes.size() < 2)
+        return;
+
+    auto model = fit_alpha_beta(sizes, latencies);
+
+    std::println("\nAlpha-beta model t(n) = alpha + n / bandwidth:");
+    print_model(model);
+
+    std::println("\n{:>12} {:>12} {:>12} {:>10}", "size, B", "measured", "model", "deviation");
+    for (auto i = 0uz; i != sizes.size(); ++i)
+        std::println("{:>12} {:>12.3f} {:>12.3f} {:>9.1f}%",
+                     sizes[i], latencies[i] / 1e3, model(sizes[i]) / 1e3,
+                     100 * (latencies[i] - model(sizes[i])) / model(sizes[i]));
+
+    print_two_regime_model(sizes, latencies);
+}
+
+} // namespace parallel
@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <ranges>
+#include <utility>
+#include <print>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "thread_baseline.hpp"
+#include "spsc_ring.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+static constexpr std::size_t ring_capacity = 1uz << 20;
+
+// the first two CPUs from the affinity mask of the process; the same CPU twice if there is one
+static std::pair<int, int> choose_cpus()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu != CPU_SETSIZE && cpus.size() != 2; ++cpu)
+        if (CPU_ISSET(cpu, &set))
+            cpus.push_back(cpu);
+
+    return {cpus.front(), cpus.back()};
+}
+
+// threads pin themselves before touching their buffers and starting the timed loop
+static void pin_this_thread(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+void measure_thread_baseline(std::size_t max_size, std::size_t n_warmup, std::size_t n_messages)
+{
+    auto [ping_cpu, pong_cpu] = choose_cpus();
+
+    std::println("Threads pinned to CPUs {} and {}{}", ping_cpu, pong_cpu,
+                 ping_cpu == pong_cpu ? " (only one CPU is available: expect poor results)" : "");
+    std::println("One-way latency through SPSC ring (half of round trip), mcs:");
+    std::println("{:>12} {:>10} {:>10} {:>10} {:>10} {:>12} {:>14}",
+                 "size, B", "messages", "min", "median", "p99", "GB/s", "stream GB/s");
+
+    for (auto size = 1uz; size <= max_size; size *= 2)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+        const std::size_t n_warm = std::min(n_warmup, n);
+
+        SPSC_Ring there{ring_capacity}, back{ring_capacity};
+
+        std::vector<double> round_trips;
+        round_trips.reserve(n);
+
+        double stream_ns = 0;
+
+        std::thread pinger{[&]
+        {
+            pin_this_thread(ping_cpu);
+
+            std::vector<char> buffer(size);
+
+            for (auto i : std::views::iota(0uz, n_warm + n))
+            {
+                auto start = std::chrono::steady_clock::now();
+
+                there.write(buffer.data(), size);
+                back.read(buffer.data(), size);
+
+                auto finish = std::chrono::steady_clock::now();
+
+                using ns = std::chrono::duration<double, std::nano>;
+                if (i >= n_warm)
+                    round_trips.push_back(ns{finish - start}.count());
+            }
+
+            // one-way stream finished by a one byte acknowledgement
+            auto start = std::chrono::steady_clock::now();
+
+            for (auto i : std::views::iota(0uz, n))
+                there.write(buffer.data(), size);
+            back.read(buffer.data(), 1);
+
+            auto finish = std::chrono::steady_clock::now();
+
+            stream_ns = std::chrono::duration<double, std::nano>(finish - start).count();
+        }};
+
+        std::thread ponger{[&]
+        {
+            pin_this_thread(pong_cpu);
+
+            std::vector<char> buffer(size);
+
+            for (auto i : std::views::iota(0uz, n_warm + n))
+            {
+                there.read(buffer.data(), size);
+                back.write(buffer.data(), size);
+            }
+
+            for (auto i : std::views::iota(0uz, n))
+                there.read(buffer.data(), size);
+            back.write(buffer.data(), 1);
+        }};
+
+        pinger.join();
+        ponger.join();
+
+        auto s = summarize(std::move(round_trips));
+        const double one_way = s.median / 2;
+
+        std::println("{:>12} {:>10} {:>10.3f} {:>10.3f} {:>10.3f} {:>12.3f} {:>14.3f}",
+                     size, n, s.min / 2e3, one_way / 1e3, s.p99 / 2e3, size / one_way,
+                     n * size / stream_ns);
+    }
+}
+
+} // namespace parallel
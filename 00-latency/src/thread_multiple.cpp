@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <print>
+
+#include <boost/mpi/environment.hpp>
+
+#include "thread_multiple.hpp"
+#include "ping_pong.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t message_size = 8;
+
+static std::string level_name(boost::mpi::threading::level level)
+{
+    std::ostringstream name;
+    name << level;
+
+    return name.str();
+}
+
+/*
+ * Thread i uses comms[i] and tag i. Prints aggregate message rate and latency of threads of node 0.
+ * A single exchange runs on the calling thread, which is allowed at any threading level
+ */
+static void run_threads(std::string_view name, const std::vector<boost::mpi::communicator> &comms,
+                        std::size_t n_warmup, std::size_t n_messages)
+{
+    const std::size_t n_threads = comms.size();
+    const int rank = comms.front().rank();
+    const int peer = 1 - rank;
+
+    std::vector<std::vector<double>> round_trips(n_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+
+    comms.front().barrier();
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto exchange = [&](std::size_t i)
+    {
+        const auto &comm = comms[i];
+        const int tag = static_cast<int>(i);
+        char buffer[message_size] = {};
+
+        round_trips[i] = ping_pong(comm, peer, n_warmup, n_messages,
+                                   [&]{ comm.send(peer, tag, buffer, message_size); },
+                                   [&]{ comm.recv(peer, tag, buffer, message_size); });
+    };
+
+    if (n_threads == 1)
+        exchange(0);
+    else
+    {
+        for (auto i = 0uz; i != n_threads; ++i)
+            threads.emplace_back(exchange, i);
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    auto finish = std::chrono::steady_clock::now();
+
+    if (rank != 0)
+        return;
+
+    std::vector<double> medians, p99s;
+    for (auto &samples : round_trips)
+    {
+        auto s = summarize(std::move(samples));
+        medians.push_back(s.median);
+        p99s.push_back(s.p99);
+    }
+
+    // every round trip consists of two messages
+    const double seconds = std::chrono::duration<double>(finish - start).count();
+    const double rate = 2.0 * n_threads * (n_warmup + n_messages) / seconds;
+
+    auto [best, worst] = std::ranges::minmax(medians);
+    std::println("{:>8} {:>8} {:>14.0f} {:>12.3f} {:>12.3f} {:>12.3f}",
+                 name, n_threads, rate, best / 1e3, worst / 1e3, std::ranges::max(p99s) / 1e3);
+}
+
+void measure_thread_multiple(const boost::mpi::communicator &world, std::size_t max_threads,
+                             std::size_t n_warmup, std::size_t n_messages)
+{
+    boost::mpi::communicator pair = world.split(world.rank() < 2 ? 0 : 1);
+    if (world.rank() > 1)
+        return;
+
+    const auto level = boost::mpi::environment::thread_level();
+
+    if (pair.rank() == 0)
+    {
+        std::println("Requested threading level: {}, granted: {}",
+                     level_name(boost::mpi::threading::multiple), level_name(level));
+
+        if (level != boost::mpi::threading::multiple)
+            std::println("Only a single thread can be measured");
+
+        std::println("\nRound trip of {}-byte messages between threads of nodes 0 and 1, mcs:",
+                     message_size);
+        std::println("{:>8} {:>8} {:>14} {:>12} {:>12} {:>12}",
+                     "by", "threads", "messages/s", "best median", "worst median", "worst p99");
+    }
+
+    if (level != boost::mpi::threading::multiple)
+        max_threads = 1;
+
+    for (auto n_threads = 1uz; n_threads <= max_threads; n_threads *= 2)
+    {
+        run_threads("tag", std::vector(n_threads, pair), n_warmup, n_messages);
+
+        // duplication is collective, so it is done before threads start
+        std::vector<boost::mpi::communicator> duplicates;
+        for (auto i = 0uz; i != n_threads; ++i)
+            duplicates.emplace_back(pair, boost::mpi::comm_duplicate);
+
+        run_threads("comm", duplicates, n_warmup, n_messages);
+    }
+}
+
+} // namespace parallel
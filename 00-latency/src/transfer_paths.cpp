@@ -0,0 +1,109 @@
+#include <cstddef>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#include <string_view>
+#include <print>
+
+#include <boost/mpi/skeleton_and_content.hpp>
+#include <boost/mpi/packed_oarchive.hpp>
+#include <boost/mpi/packed_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "transfer_paths.hpp"
+#include "ping_pong.hpp"
+#include "statistics.hpp"
+
+namespace parallel
+{
+
+static constexpr std::size_t bytes_per_size = 1uz << 30;
+static constexpr std::size_t min_messages = 5;
+
+/*
+ * Runs ping-pong and prints the result on node 0. CPU time is that of node 0 averaged over all
+ * round trips including warmup ones
+ */
+template<typename Send, typename Recv>
+static void run_path(const boost::mpi::communicator &world, std::string_view name,
+                     std::size_t size, std::size_t n_warmup, std::size_t n_messages,
+                     Send send, Recv recv)
+{
+    const int peer = 1 - world.rank();
+
+    std::clock_t cpu_start = std::clock();
+    auto round_trips = ping_pong(world, peer, n_warmup, n_messages, send, recv);
+    std::clock_t cpu_finish = std::clock();
+
+    if (world.rank() != 0)
+        return;
+
+    auto s = summarize(std::move(round_trips));
+    const double cpu_mcs =
+        1e6 * (cpu_finish - cpu_start) / CLOCKS_PER_SEC / (n_warmup + n_messages);
+
+    std::println("{:>12} {:>12} {:>10} {:>12.3f} {:>12.3f} {:>12.3f} {:>12.3f}",
+                 size, name, n_messages, s.min / 1e3, s.median / 1e3, s.p99 / 1e3, cpu_mcs);
+}
+
+void measure_transfer_paths(const boost::mpi::communicator &world, std::size_t max_size,
+                            std::size_t n_warmup, std::size_t n_messages)
+{
+    if (world.rank() > 1)
+        return;
+
+    constexpr int tag = 0;
+    const int peer = 1 - world.rank();
+
+    if (world.rank() == 0)
+    {
+        std::println("Round trip of std::vector<double> between nodes 0 and 1, mcs:");
+        std::println("{:>12} {:>12} {:>10} {:>12} {:>12} {:>12} {:>12}",
+                     "size, B", "path", "messages", "min", "median", "p99", "CPU time");
+    }
+
+    for (auto size = sizeof(double); size <= max_size; size *= 16)
+    {
+        const std::size_t n = std::max(min_messages, std::min(n_messages, bytes_per_size / size));
+        const std::size_t n_warm = std::min(n_warmup, n);
+        const std::size_t n_elems = size / sizeof(double);
+        const int count = static_cast<int>(n_elems);
+
+        std::vector<double> payload(n_elems, 3.14);
+
+        run_path(world, "serialized", size, n_warm, n,
+                 [&]{ world.send(peer, tag, payload); },
+                 [&]{ world.recv(peer, tag, payload); });
+
+        run_path(world, "raw", size, n_warm, n,
+                 [&]{ world.send(peer, tag, payload.data(), count); },
+                 [&]{ world.recv(peer, tag, payload.data(), count); });
+
+        // the skeleton travels once: after that only the content of the vector is transferred
+        if (world.rank() == 0)
+            world.send(peer, tag, boost::mpi::skeleton(payload));
+        else
+            world.recv(peer, tag, boost::mpi::skeleton(payload));
+
+        boost::mpi::content content = boost::mpi::get_content(payload);
+        run_path(world, "skeleton", size, n_warm, n,
+                 [&]{ world.send(peer, tag, content); },
+                 [&]{ world.recv(peer, tag, content); });
+
+        run_path(world, "packed", size, n_warm, n,
+                 [&]
+                 {
+                     boost::mpi::packed_oarchive archive{world};
+                     archive << payload;
+                     world.send(peer, tag, archive);
+                 },
+                 [&]
+                 {
+                     boost::mpi::packed_iarchive archive{world};
+                     world.recv(peer, tag, archive);
+                     archive >> payload;
+                 });
+    }
+}
+
+} // namespace parallel
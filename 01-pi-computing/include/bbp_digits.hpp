@@ -0,0 +1,35 @@
+#ifndef INCLUDE_BBP_DIGITS_HPP
+#define INCLUDE_BBP_DIGITS_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace parallel
+{
+
+/*
+ * Hexadecimal digits of pi from an arbitrary position without computing the previous ones:
+ * the fractional part of 16^position * pi is the fractional part of
+ * 4 * S_1 - 2 * S_4 - S_5 - S_6, where S_j is the sum of 16^(position - k) / (8k + j) over all k.
+ * Terms with k < position are computed as (16^(position - k) mod (8k + j)) / (8k + j), the rest
+ * are small and computed directly, so only machine words are needed.
+ *
+ * The long double sum is accurate enough for hex_chunk_digits digits while position is below 10^8
+ */
+inline constexpr std::size_t hex_chunk_digits = 8;
+
+// the number of terms beyond position that are not negligible
+inline constexpr std::size_t hex_tail_terms = 24;
+
+/*
+ * Fractional part of the terms [from; to) of 16^position * pi. Terms of a series can be split
+ * between any number of ranges: the fractional part of the sum of their results is the answer
+ */
+long double bbp_hex_fraction(std::size_t position, std::size_t from, std::size_t to);
+
+// the first n_digits hexadecimal digits of the fractional part of x
+std::string hex_digits(long double x, std::size_t n_digits);
+
+} // namespace parallel
+
+#endif // INCLUDE_BBP_DIGITS_HPP
@@ -0,0 +1,45 @@
+#ifndef INCLUDE_CHECKPOINT_HPP
+#define INCLUDE_CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+#include "pi_computation.hpp"
+#include "chudnovsky.hpp"
+
+namespace parallel
+{
+
+/*
+ * Checkpoint of a node is the number of its terms already summed and their exact sum in the wire
+ * format. The file starts with words identifying the run (engine, partition, the number of terms,
+ * the rank and the number of nodes), so a checkpoint is never resumed by a different run
+ */
+using Run_Key = std::vector<std::uint64_t>;
+
+std::filesystem::path checkpoint_path(const std::filesystem::path &dir, int rank);
+
+/*
+ * Writes the checkpoint to a temporary file and renames it, so the previous checkpoint stays
+ * intact if the node is killed while writing. Returns the size of the file in bytes
+ */
+std::size_t save_checkpoint(const std::filesystem::path &path, const Run_Key &key,
+                            std::size_t n_terms_done, const BBP_Sum &sum);
+std::size_t save_checkpoint(const std::filesystem::path &path, const Run_Key &key,
+                            std::size_t n_terms_done, const Chudnovsky_Sum &sum);
+
+/*
+ * Returns the number of terms summed in the checkpoint or nothing if there is no checkpoint.
+ * Throws if the checkpoint was written by another run or is damaged
+ */
+std::optional<std::size_t> load_checkpoint(const std::filesystem::path &path, const Run_Key &key,
+                                           BBP_Sum &sum);
+std::optional<std::size_t> load_checkpoint(const std::filesystem::path &path, const Run_Key &key,
+                                           Chudnovsky_Sum &sum);
+
+} // namespace parallel
+
+#endif // INCLUDE_CHECKPOINT_HPP
@@ -0,0 +1,64 @@
+#ifndef INCLUDE_CHUDNOVSKY_HPP
+#define INCLUDE_CHUDNOVSKY_HPP
+
+#include <cstddef>
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace parallel
+{
+
+/*
+ * Binary splitting triple of the Chudnovsky series over a range of terms [a; b):
+ * P(a, b) = p(a) * ... * p(b - 1), Q(a, b) = q(a) * ... * q(b - 1) and T(a, b) / Q(a, b) equal
+ * to the sum of (13591409 + 545140134k) * P(a, k + 1) / Q(a, k + 1) over k from [a; b), where
+ * p(k) = -(6k - 5)(2k - 1)(6k - 1), q(k) = 640320^3 / 24 * k^3 and p(0) = q(0) = 1.
+ * Then pi = 426880 * sqrt(10005) * Q(0, n) / T(0, n). Every term adds about 14 decimal digits
+ */
+struct Chudnovsky_Sum
+{
+    boost::multiprecision::cpp_int P = 1;
+    boost::multiprecision::cpp_int Q = 1;
+    boost::multiprecision::cpp_int T = 0;
+
+    // appends the range of rhs that must immediately follow the range of *this
+    Chudnovsky_Sum &operator+=(const Chudnovsky_Sum &rhs) { return add(rhs, 1); }
+
+    // the same as += with long multiplications split between n_threads threads
+    Chudnovsky_Sum &add(const Chudnovsky_Sum &rhs, unsigned n_threads);
+};
+
+/*
+ * Computes the triple for terms [from; to) splitting the range in halves recursively. The left
+ * halves are given to new threads while there are threads left
+ */
+Chudnovsky_Sum chudnovsky_binary_splitting(std::size_t from, std::size_t to,
+                                           unsigned n_threads = 1);
+
+// the number of terms giving digits decimal places with some guard digits
+std::size_t chudnovsky_terms_for_digits(std::size_t digits);
+
+// decimal places the first n_terms terms guarantee without guard digits
+std::size_t chudnovsky_guaranteed_digits(std::size_t n_terms);
+
+/*
+ * floor(pi * 10^digits) given the triple for the first n_terms terms. Pi is computed with guard
+ * digits, and the result is returned once rounding errors cannot change the last printed digit.
+ * Otherwise more guard digits and terms are added
+ */
+boost::multiprecision::cpp_int pi_digits(Chudnovsky_Sum sum, std::size_t n_terms,
+                                         std::size_t digits, unsigned n_threads = 1);
+
+boost::multiprecision::cpp_dec_float_50 ratio_to_float(const Chudnovsky_Sum &sum);
+
+/*
+ * floor(sqrt(x)) by Newton's method. The initial approximation is the root of the upper half of x
+ * computed recursively, so only a couple of iterations are done with the full length of x
+ */
+boost::multiprecision::cpp_int integer_sqrt(const boost::multiprecision::cpp_int &x,
+                                            unsigned n_threads = 1);
+
+} // namespace parallel
+
+#endif // INCLUDE_CHUDNOVSKY_HPP
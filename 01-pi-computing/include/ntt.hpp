@@ -0,0 +1,46 @@
+#ifndef INCLUDE_NTT_HPP
+#define INCLUDE_NTT_HPP
+
+#include <cstddef>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace parallel
+{
+
+/*
+ * Arithmetic on long cpp_int numbers. Multiplication of numbers split into 16-bit digits is
+ * a cyclic convolution computed by the number theoretic transform modulo the prime
+ * 2^64 - 2^32 + 1: coefficients of the convolution of up to 2^32 digits are less than the
+ * modulus, so a single prime is enough. Division multiplies by the reciprocal of the divisor
+ * found by Newton's method. Stages of transforms are split between n_threads threads.
+ *
+ * Below the thresholds (in 64-bit limbs of the shorter operand) cpp_int operators are faster, so
+ * multiply() and divide() fall back on them
+ */
+inline constexpr std::size_t ntt_multiplication_threshold = 12288;
+inline constexpr std::size_t newton_division_threshold = 512;
+
+boost::multiprecision::cpp_int multiply(const boost::multiprecision::cpp_int &a,
+                                        const boost::multiprecision::cpp_int &b,
+                                        unsigned n_threads = 1);
+
+// floor(a / b) for non-negative a and positive b, otherwise a / b of cpp_int
+boost::multiprecision::cpp_int divide(const boost::multiprecision::cpp_int &a,
+                                      const boost::multiprecision::cpp_int &b,
+                                      unsigned n_threads = 1);
+
+boost::multiprecision::cpp_int power(boost::multiprecision::cpp_int base, std::size_t exponent,
+                                     unsigned n_threads = 1);
+
+// the algorithms themselves regardless of the size of operands
+boost::multiprecision::cpp_int ntt_multiply(const boost::multiprecision::cpp_int &a,
+                                            const boost::multiprecision::cpp_int &b,
+                                            unsigned n_threads = 1);
+boost::multiprecision::cpp_int newton_divide(const boost::multiprecision::cpp_int &a,
+                                             const boost::multiprecision::cpp_int &b,
+                                             unsigned n_threads = 1);
+
+} // namespace parallel
+
+#endif // INCLUDE_NTT_HPP
@@ -0,0 +1,66 @@
+#ifndef INCLUDE_PARTITION_HPP
+#define INCLUDE_PARTITION_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <functional>
+#include <optional>
+
+namespace parallel
+{
+
+// terms from, from + stride, from + 2 * stride, ... that are less than to
+struct Term_Range
+{
+    std::size_t from;
+    std::size_t to;
+    std::size_t stride = 1;
+
+    std::size_t size() const noexcept { return (to > from) ? (to - from - 1) / stride + 1 : 0; }
+};
+
+/*
+ * How terms [0; n_terms) are distributed between nodes:
+ * - block: equal contiguous ranges;
+ * - cyclic: term k goes to node k mod size;
+ * - block_cyclic: blocks of block_size terms are dealt to nodes in turn;
+ * - balanced: contiguous ranges of equal cost according to a cost model
+ */
+enum class Partition
+{
+    block,
+    cyclic,
+    block_cyclic,
+    balanced
+};
+
+std::optional<Partition> to_partition(std::string_view name);
+
+// whether every node gets one contiguous range, and ranges ascend with the rank
+bool is_contiguous(Partition partition);
+
+/*
+ * Cost of terms [0; n): the sum of lengths of their operands in bits. Both P, Q, T of Chudnovsky
+ * and T, Q of BBP grow by a constant plus a multiple of log2(k) bits per term, so sums of
+ * logarithms are computed in closed form by std::lgamma
+ */
+using Cost_Model = std::function<double(std::size_t n)>;
+
+double bbp_cost(std::size_t n);
+double chudnovsky_cost(std::size_t n);
+
+std::vector<Term_Range> partition_terms(Partition partition, std::size_t n_terms, int rank,
+                                        int size, std::size_t block_size, const Cost_Model &cost);
+
+/*
+ * Terms number [first; first + count) of the sequence of terms of all ranges one after another,
+ * so that a node can sum its terms by portions
+ */
+std::vector<Term_Range> slice_terms(std::span<const Term_Range> ranges, std::size_t first,
+                                    std::size_t count);
+
+} // namespace parallel
+
+#endif // INCLUDE_PARTITION_HPP
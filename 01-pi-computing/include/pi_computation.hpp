@@ -2,6 +2,9 @@
 #define INCLUDE_PI_COMPUTATION_HPP
 
 #include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <functional>
 
 #include <boost/multiprecision/cpp_dec_float.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -9,10 +12,78 @@
 namespace parallel
 {
 
+/*
+ * Exact partial sum of the series equal to T / (Q * 2^shift).
+ *
+ * The k-th term of the series is (120k^2 + 151k + 47) / (512k^4 + 1024k^3 + 712k^2 + 194k + 15)
+ * divided by 16^k, so a single term is {numerator, denominator, 4k}. Two sums are added without
+ * any gcd computations, thus operands grow linearly with the number of terms
+ */
+struct BBP_Sum
+{
+    boost::multiprecision::cpp_int T = 0;
+    boost::multiprecision::cpp_int Q = 1;
+    std::size_t shift = 0;
+
+    BBP_Sum &operator+=(const BBP_Sum &rhs) { return add(rhs, 1); }
+
+    // the same as += with long multiplications split between n_threads threads
+    BBP_Sum &add(const BBP_Sum &rhs, unsigned n_threads);
+
+    boost::multiprecision::cpp_rational to_rational() const;
+};
+
+/*
+ * Sums terms from, from + stride, ... below to splitting the range in halves recursively, so that
+ * operands of each addition are of about the same size. The left halves are given to new threads
+ * while there are threads left
+ */
+BBP_Sum bbp_binary_splitting(std::size_t from, std::size_t to, std::size_t stride = 1,
+                             unsigned n_threads = 1);
+
+/*
+ * The number of terms such that the rest of the series is less than 10^-digits. Every term adds
+ * log10(16) ~ 1.2 decimal digits
+ */
+std::size_t bbp_terms_for_digits(std::size_t digits);
+
+/*
+ * floor(pi * 10^digits) given the sum of the first n_terms terms. All terms are positive and the
+ * rest of the series is less than 4 / 16^n_terms, so the digits are known for sure when both ends
+ * of that interval agree on them. If they do not, more terms are added until they do
+ */
+boost::multiprecision::cpp_int pi_digits(BBP_Sum sum, std::size_t n_terms, std::size_t digits,
+                                         unsigned n_threads = 1);
+
+// decimal places the first n_terms terms guarantee, as the rest of the series is below 4 / 16^n
+std::size_t bbp_guaranteed_digits(std::size_t n_terms);
+
+// receives consecutive chunks of decimal digits and returns whether more chunks are needed
+using Digit_Sink = std::function<bool(std::string_view chunk)>;
+
+/*
+ * Passes floor(pi * 10^digits) written as "3.1415..." to sink by chunks from left to right. Unlike
+ * cpp_int::str() that takes quadratic time, splits the number in halves by powers of 10
+ * recursively, so conversion is as fast as division, and the rest of it is skipped once sink
+ * returns false. Returns whether all chunks were passed
+ */
+bool for_each_digit_chunk(const boost::multiprecision::cpp_int &scaled_pi, std::size_t digits,
+                          const Digit_Sink &sink);
+
+// writes floor(pi * 10^digits) as "3.1415..." with digits decimal places
+void write_digits(std::ostream &os, const boost::multiprecision::cpp_int &scaled_pi,
+                  std::size_t digits);
+
 boost::multiprecision::cpp_dec_float_50 compute_pi(std::size_t n_iterations);
 boost::multiprecision::cpp_rational compute_part_of_pi_series(std::size_t from, std::size_t to);
 boost::multiprecision::cpp_dec_float_50 ratio_to_float(boost::multiprecision::cpp_rational r);
 
+/*
+ * Unlike to_rational(), does not normalize the sum: the only long operation is one division.
+ * The result only depends on the value of the sum, not on the way it was accumulated
+ */
+boost::multiprecision::cpp_dec_float_50 ratio_to_float(const BBP_Sum &sum);
+
 } // namespace parallel
 
 #endif // INCLUDE_PI_COMPUTATION_HPP
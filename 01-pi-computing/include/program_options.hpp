@@ -11,7 +11,12 @@ namespace parallel
 
 namespace po = boost::program_options;
 
-auto set_program_options(int argc, char *argv[], std::string_view n_iter_desc)
+/*
+ * Options common for both programs. Options that only make sense for one of them are passed as
+ * extra_options
+ */
+auto set_program_options(int argc, char *argv[], std::string_view n_iter_desc,
+                         const po::options_description &extra_options = {})
     -> std::pair<po::options_description, po::variables_map>;
 
 } // namespace parallel
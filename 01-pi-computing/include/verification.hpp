@@ -0,0 +1,24 @@
+#ifndef INCLUDE_VERIFICATION_HPP
+#define INCLUDE_VERIFICATION_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace parallel
+{
+
+/*
+ * Compares floor(pi * 10^digits) written as "3.1415..." with a reference file of the same format
+ * mapped to memory. Digits are converted and compared by chunks, so conversion stops at the first
+ * mismatch. The reference may be longer or shorter than the result: only the common part is
+ * compared. Reports the result to os and returns whether all compared digits match
+ */
+bool verify_digits(std::ostream &os, const boost::multiprecision::cpp_int &scaled_pi,
+                   std::size_t digits, const std::string &reference_path);
+
+} // namespace parallel
+
+#endif // INCLUDE_VERIFICATION_HPP
@@ -0,0 +1,37 @@
+#ifndef INCLUDE_WIRE_FORMAT_HPP
+#define INCLUDE_WIRE_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <span>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "pi_computation.hpp"
+#include "chudnovsky.hpp"
+
+namespace parallel
+{
+
+/*
+ * Compact binary representation of partial sums sent between nodes: every integer is written as
+ * its sign, the number of limbs and the limbs themselves copied from cpp_int as they are. Unlike
+ * Boost.Serialization, encoding is a memcpy, and the buffer is sent as a contiguous array of
+ * 64-bit words
+ */
+using Wire_Buffer = std::vector<std::uint64_t>;
+
+void encode(const boost::multiprecision::cpp_int &x, Wire_Buffer &buffer);
+void encode(const BBP_Sum &sum, Wire_Buffer &buffer);
+void encode(const Chudnovsky_Sum &sum, Wire_Buffer &buffer);
+
+// reads a value starting at position and moves position past it
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position,
+            boost::multiprecision::cpp_int &x);
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position, BBP_Sum &sum);
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position, Chudnovsky_Sum &sum);
+
+} // namespace parallel
+
+#endif // INCLUDE_WIRE_FORMAT_HPP
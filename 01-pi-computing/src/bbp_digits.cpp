@@ -0,0 +1,83 @@
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <string>
+
+#include "bbp_digits.hpp"
+
+namespace parallel
+{
+
+static std::uint64_t pow_mod(std::uint64_t base, std::uint64_t exp, std::uint64_t mod)
+{
+    using uint128 = unsigned __int128;
+
+    std::uint64_t result = 1 % mod;
+    base %= mod;
+
+    for (; exp != 0; exp >>= 1)
+    {
+        if (exp & 1)
+            result = static_cast<uint128>(result) * base % mod;
+        base = static_cast<uint128>(base) * base % mod;
+    }
+
+    return result;
+}
+
+// x - floor(x) rounds to 1 for tiny negative x, which is not a fraction and yields the digit 16
+static long double fraction(long double x)
+{
+    const long double f = x - std::floor(x);
+    return (f < 1) ? f : std::nextafter(1.0L, 0.0L);
+}
+
+// fractional part of the sum of 16^(position - k) / (8k + j) over k from [from; to)
+static long double series_fraction(std::size_t position, std::size_t from, std::size_t to,
+                                   unsigned j)
+{
+    long double sum = 0;
+
+    std::size_t k = from;
+    for (; k < to && k < position; ++k)
+    {
+        const std::uint64_t denominator = 8 * k + j;
+        sum = fraction(sum + static_cast<long double>(pow_mod(16, position - k, denominator))
+                             / denominator);
+    }
+
+    long double power = std::pow(16.0L, static_cast<long double>(position) - k);
+    for (; k < to; ++k, power /= 16)
+        sum = fraction(sum + power / (8 * k + j));
+
+    return sum;
+}
+
+long double bbp_hex_fraction(std::size_t position, std::size_t from, std::size_t to)
+{
+    return fraction(4 * series_fraction(position, from, to, 1)
+                  - 2 * series_fraction(position, from, to, 4)
+                  - series_fraction(position, from, to, 5)
+                  - series_fraction(position, from, to, 6));
+}
+
+std::string hex_digits(long double x, std::size_t n_digits)
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+
+    std::string hex;
+    hex.reserve(n_digits);
+
+    x = fraction(x);
+    for (std::size_t i = 0; i != n_digits; ++i)
+    {
+        x *= 16;
+        const auto digit = static_cast<unsigned>(x);
+        hex.push_back(digits[digit]);
+        x -= digit;
+    }
+
+    return hex;
+}
+
+} // namespace parallel
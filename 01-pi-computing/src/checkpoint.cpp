@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+#include <filesystem>
+
+#include "checkpoint.hpp"
+#include "wire_format.hpp"
+
+namespace parallel
+{
+
+namespace fs = std::filesystem;
+
+// "PICKPT01" read as a little-endian word
+static constexpr std::uint64_t magic = 0x313054504B434950;
+
+fs::path checkpoint_path(const fs::path &dir, int rank)
+{
+    return dir / ("rank-" + std::to_string(rank) + ".ckpt");
+}
+
+template<typename Sum>
+static std::size_t save(const fs::path &path, const Run_Key &key, std::size_t n_terms_done,
+                        const Sum &sum)
+{
+    Wire_Buffer buffer{magic, key.size()};
+    buffer.insert(buffer.end(), key.begin(), key.end());
+    buffer.push_back(n_terms_done);
+    encode(sum, buffer);
+
+    fs::path tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream out{tmp_path, std::ios::binary | std::ios::trunc};
+        if (!out.is_open())
+            throw std::runtime_error{"Could not open file " + tmp_path.string()};
+
+        out.write(reinterpret_cast<const char *>(buffer.data()),
+                  buffer.size() * sizeof(buffer[0]));
+        if (!out.flush())
+            throw std::runtime_error{"Could not write file " + tmp_path.string()};
+    }
+
+    fs::rename(tmp_path, path);
+
+    return buffer.size() * sizeof(buffer[0]);
+}
+
+template<typename Sum>
+static std::optional<std::size_t> load(const fs::path &path, const Run_Key &key, Sum &sum)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in.is_open())
+        return std::nullopt;
+
+    const auto file_size = fs::file_size(path);
+    if (file_size % sizeof(std::uint64_t))
+        throw std::runtime_error{"Checkpoint " + path.string() + " is damaged"};
+
+    Wire_Buffer buffer(file_size / sizeof(std::uint64_t));
+    in.read(reinterpret_cast<char *>(buffer.data()), file_size);
+    if (!in)
+        throw std::runtime_error{"Could not read checkpoint " + path.string()};
+
+    const std::size_t header_size = 2 + key.size() + 1;
+    if (buffer.size() < header_size || buffer[0] != magic || buffer[1] != key.size()
+        || !std::equal(key.begin(), key.end(), buffer.begin() + 2))
+        throw std::runtime_error{"Checkpoint " + path.string() + " belongs to another run"};
+
+    std::size_t position = header_size;
+    decode(buffer, position, sum);
+
+    return buffer[header_size - 1];
+}
+
+std::size_t save_checkpoint(const fs::path &path, const Run_Key &key, std::size_t n_terms_done,
+                            const BBP_Sum &sum)
+{
+    return save(path, key, n_terms_done, sum);
+}
+
+std::size_t save_checkpoint(const fs::path &path, const Run_Key &key, std::size_t n_terms_done,
+                            const Chudnovsky_Sum &sum)
+{
+    return save(path, key, n_terms_done, sum);
+}
+
+std::optional<std::size_t> load_checkpoint(const fs::path &path, const Run_Key &key,
+                                           BBP_Sum &sum)
+{
+    return load(path, key, sum);
+}
+
+std::optional<std::size_t> load_checkpoint(const fs::path &path, const Run_Key &key,
+                                           Chudnovsky_Sum &sum)
+{
+    return load(path, key, sum);
+}
+
+} // namespace parallel
@@ -0,0 +1,180 @@
+#include <cstddef>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include <limits>
+#include <future>
+#include <utility>
+
+#include "chudnovsky.hpp"
+#include "ntt.hpp"
+
+namespace parallel
+{
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_dec_float_50;
+
+// 640320^3 / 24
+static const cpp_int q_factor{"10939058860032000"};
+
+static constexpr unsigned A = 13591409;
+static constexpr unsigned B = 545140134;
+static constexpr unsigned C = 426880;
+static constexpr unsigned D = 10005;
+
+// decimal digits per term: log10(640320^3 / 1728)
+static constexpr double digits_per_term = 14.181647462725477;
+
+static constexpr std::size_t guard_digits = 16;
+
+// roots of shorter numbers are found by Newton's method right away
+static constexpr std::size_t sqrt_base_bits = 1024;
+
+Chudnovsky_Sum &Chudnovsky_Sum::add(const Chudnovsky_Sum &rhs, unsigned n_threads)
+{
+    T = multiply(T, rhs.Q, n_threads);
+    T += multiply(P, rhs.T, n_threads);
+    P = multiply(P, rhs.P, n_threads);
+    Q = multiply(Q, rhs.Q, n_threads);
+
+    return *this;
+}
+
+static Chudnovsky_Sum chudnovsky_term(std::size_t k)
+{
+    if (k == 0)
+        return Chudnovsky_Sum{.P = 1, .Q = 1, .T = A};
+
+    cpp_int K = k;
+    cpp_int P = -(6 * K - 5) * (2 * K - 1) * (6 * K - 1);
+    cpp_int T = P * (A + B * K);
+
+    return Chudnovsky_Sum{.P = std::move(P), .Q = q_factor * K * K * K, .T = std::move(T)};
+}
+
+Chudnovsky_Sum chudnovsky_binary_splitting(std::size_t from, std::size_t to, unsigned n_threads)
+{
+    if (from >= to)
+        return Chudnovsky_Sum{};
+    else if (to - from == 1)
+        return chudnovsky_term(from);
+
+    const std::size_t middle = from + (to - from) / 2;
+
+    if (n_threads <= 1)
+    {
+        Chudnovsky_Sum sum = chudnovsky_binary_splitting(from, middle);
+        sum += chudnovsky_binary_splitting(middle, to);
+
+        return sum;
+    }
+
+    const unsigned left_threads = n_threads / 2;
+
+    auto left = std::async(std::launch::async, chudnovsky_binary_splitting,
+                           from, middle, left_threads);
+    Chudnovsky_Sum right = chudnovsky_binary_splitting(middle, to, n_threads - left_threads);
+
+    Chudnovsky_Sum sum = left.get();
+    sum.add(right, n_threads);
+
+    return sum;
+}
+
+std::size_t chudnovsky_terms_for_digits(std::size_t digits)
+{
+    return static_cast<std::size_t>(std::ceil((digits + guard_digits) / digits_per_term)) + 1;
+}
+
+/*
+ * Terms of the series alternate and decrease, so the rest after n terms is less than the term
+ * t_n = (6n)! (A + Bn) / ((3n)! (n!)^3 640320^(3n)). The sum is about A, hence the error of pi is
+ * less than pi * t_n / A
+ */
+std::size_t chudnovsky_guaranteed_digits(std::size_t n_terms)
+{
+    if (n_terms == 0)
+        return 0;
+
+    const double n = static_cast<double>(n_terms);
+    const double log10_term = std::numbers::log10e * (std::lgamma(6 * n + 1)
+                                                      - std::lgamma(3 * n + 1)
+                                                      - 3 * std::lgamma(n + 1))
+                            + std::log10(A + B * n) - 3 * n * std::log10(640320.0);
+    const double log10_error = log10_term + std::log10(std::numbers::pi / A);
+
+    return static_cast<std::size_t>(std::max(-log10_error, 0.0));
+}
+
+cpp_int integer_sqrt(const cpp_int &x, unsigned n_threads)
+{
+    if (x < 2)
+        return x;
+
+    // start above the root: Newton's iterations then decrease monotonically
+    const std::size_t n_bits = boost::multiprecision::msb(x) + 1;
+    cpp_int root;
+    if (n_bits <= sqrt_base_bits)
+        root = cpp_int{1} << (n_bits / 2 + 1);
+    else
+    {
+        // sqrt(x) <= (sqrt(x / 4^k) + 1) * 2^k with about a half of correct bits
+        const std::size_t k = n_bits / 4;
+        root = (integer_sqrt(x >> (2 * k), n_threads) + 1) << k;
+    }
+
+    for (;;)
+    {
+        cpp_int next = (root + divide(x, root, n_threads)) >> 1;
+        if (next >= root)
+            return root;
+
+        root = std::move(next);
+    }
+}
+
+// pi * 10^precision: besides the rest of the series, the absolute error is less than 2
+static cpp_int scaled_pi(const Chudnovsky_Sum &sum, std::size_t precision, unsigned n_threads = 1)
+{
+    const cpp_int scale = power(10, precision, n_threads);
+    const cpp_int sqrt_D = integer_sqrt(D * multiply(scale, scale, n_threads), n_threads);
+
+    return divide(multiply(C * sqrt_D, sum.Q, n_threads), sum.T, n_threads);
+}
+
+cpp_int pi_digits(Chudnovsky_Sum sum, std::size_t n_terms, std::size_t digits,
+                  unsigned n_threads)
+{
+    constexpr unsigned max_error = 4;
+
+    for (std::size_t guard = guard_digits; ; guard *= 2)
+    {
+        if (const std::size_t needed = chudnovsky_terms_for_digits(digits + guard - guard_digits);
+            n_terms < needed)
+        {
+            sum.add(chudnovsky_binary_splitting(n_terms, needed, n_threads), n_threads);
+            n_terms = needed;
+        }
+
+        const cpp_int pi = scaled_pi(sum, digits + guard, n_threads);
+        const cpp_int guard_scale = power(10, guard, n_threads);
+
+        const cpp_int lower = divide(pi - max_error, guard_scale, n_threads);
+        const cpp_int upper = divide(pi + max_error, guard_scale, n_threads);
+
+        if (lower == upper)
+            return lower;
+    }
+}
+
+cpp_dec_float_50 ratio_to_float(const Chudnovsky_Sum &sum)
+{
+    constexpr auto digits = std::numeric_limits<cpp_dec_float_50>::max_digits10;
+
+    const cpp_int scale = boost::multiprecision::pow(cpp_int{10}, digits);
+
+    return cpp_dec_float_50{scaled_pi(sum, digits)} / cpp_dec_float_50{scale};
+}
+
+} // namespace parallel
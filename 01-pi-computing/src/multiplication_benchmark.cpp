@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <optional>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/program_options.hpp>
+
+#include "ntt.hpp"
+
+/*
+ * Compares multiplication and division of cpp_int with the NTT multiplication and Newton's
+ * division for operands of growing length to find sizes where the latter become faster
+ */
+
+using boost::multiprecision::cpp_int;
+
+static cpp_int random_number(std::mt19937_64 &engine, std::size_t n_limbs)
+{
+    cpp_int x = 0;
+    for (std::size_t i = 0; i != n_limbs; ++i)
+    {
+        x <<= 64;
+        x += engine();
+    }
+
+    return x;
+}
+
+// the least time of n_repetitions calls of f in ms
+template<typename F>
+static double measure(std::size_t n_repetitions, F f)
+{
+    double best = 0;
+    for (std::size_t i = 0; i != n_repetitions; ++i)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        cpp_int result = f();
+        auto finish = std::chrono::high_resolution_clock::now();
+
+        const double time = std::chrono::duration<double, std::milli>(finish - start).count();
+        if (i == 0 || time < best)
+            best = time;
+    }
+
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    po::options_description desc{"Allowed options"};
+
+    desc.add_options()
+        ("help", "Produce help message")
+        ("min-limbs", po::value<std::size_t>()->default_value(16),
+         "Set the length of the shortest operands in 64-bit limbs")
+        ("max-limbs", po::value<std::size_t>()->default_value(1 << 16),
+         "Set the length of the longest operands in 64-bit limbs")
+        ("repetitions", po::value<std::size_t>()->default_value(3),
+         "Set the number of measurements of every operation (the best one is reported)")
+        ("threads", po::value<unsigned>()->default_value(1),
+         "Set the number of threads running transforms");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto min_limbs = vm["min-limbs"].as<std::size_t>();
+    const auto max_limbs = vm["max-limbs"].as<std::size_t>();
+    const auto n_repetitions = vm["repetitions"].as<std::size_t>();
+    const auto n_threads = vm["threads"].as<unsigned>();
+
+    std::mt19937_64 engine;
+
+    std::optional<std::size_t> multiplication_crossover, division_crossover;
+
+    std::cout << "Time in ms; division is of a 2n-limb number by an n-limb one" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(14) << "cpp_int *" << std::setw(14) << "NTT"
+              << std::setw(14) << "cpp_int /" << std::setw(14) << "Newton" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (std::size_t n_limbs = min_limbs; n_limbs <= max_limbs; n_limbs *= 2)
+    {
+        const cpp_int a = random_number(engine, n_limbs);
+        const cpp_int b = random_number(engine, n_limbs);
+        const cpp_int c = random_number(engine, 2 * n_limbs);
+
+        auto boost_mul = measure(n_repetitions, [&]{ return cpp_int{a * b}; });
+        auto ntt_mul = measure(n_repetitions,
+                               [&]{ return parallel::ntt_multiply(a, b, n_threads); });
+        auto boost_div = measure(n_repetitions, [&]{ return cpp_int{c / b}; });
+        auto newton_div = measure(n_repetitions,
+                                  [&]{ return parallel::newton_divide(c, b, n_threads); });
+
+        if (!multiplication_crossover && ntt_mul < boost_mul)
+            multiplication_crossover = n_limbs;
+        if (!division_crossover && newton_div < boost_div)
+            division_crossover = n_limbs;
+
+        std::cout << std::setw(10) << n_limbs << std::setw(14) << boost_mul << std::setw(14)
+                  << ntt_mul << std::setw(14) << boost_div << std::setw(14) << newton_div
+                  << std::endl;
+    }
+
+    std::cout << "\nNTT multiplication is faster from: ";
+    if (multiplication_crossover)
+        std::cout << *multiplication_crossover << " limbs" << std::endl;
+    else
+        std::cout << "never" << std::endl;
+
+    std::cout << "Newton's division is faster from: ";
+    if (division_crossover)
+        std::cout << *division_crossover << " limbs" << std::endl;
+    else
+        std::cout << "never" << std::endl;
+
+    std::cout << "Thresholds used: " << parallel::ntt_multiplication_threshold << " and "
+              << parallel::newton_division_threshold << " limbs" << std::endl;
+
+    return 0;
+}
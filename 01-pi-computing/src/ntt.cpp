@@ -0,0 +1,483 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "ntt.hpp"
+
+namespace parallel
+{
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::limb_type;
+
+static_assert(sizeof(limb_type) == sizeof(std::uint64_t), "Limbs of cpp_int must be 64-bit");
+
+namespace
+{
+
+using uint128 = unsigned __int128;
+
+constexpr std::uint64_t modulus = 0xFFFF'FFFF'0000'0001;
+constexpr std::uint64_t epsilon = 0xFFFF'FFFF; // 2^64 mod modulus
+
+// 7 generates the multiplicative group, whose order is divisible by 2^32
+constexpr std::uint64_t generator = 7;
+
+constexpr unsigned digit_bits = 16;
+constexpr unsigned digits_per_limb = 64 / digit_bits;
+
+// stages shorter than this many butterflies are not worth starting threads
+constexpr std::size_t min_parallel_butterflies = 1 << 14;
+
+// reciprocals shorter than this are computed by division of cpp_int
+constexpr std::size_t reciprocal_base_bits = 64 * 64;
+
+// blocks of this many values are transformed stage by stage as they fit in L1 cache
+constexpr std::size_t cached_block_size = 1 << 11;
+
+/*
+ * Values are reduced by selects rather than branches: they depend on the data, so branches would
+ * be mispredicted half of the time
+ */
+std::uint64_t add(std::uint64_t a, std::uint64_t b)
+{
+    const std::uint64_t complement = modulus - b;
+    const std::uint64_t difference = a - complement;
+
+    return (a < complement) ? difference + modulus : difference;
+}
+
+std::uint64_t sub(std::uint64_t a, std::uint64_t b)
+{
+    const std::uint64_t difference = a - b;
+
+    return (a < b) ? difference + modulus : difference;
+}
+
+// 2^64 = 2^32 - 1 and 2^96 = -1 modulo 2^64 - 2^32 + 1
+std::uint64_t mul(std::uint64_t a, std::uint64_t b)
+{
+    const uint128 product = static_cast<uint128>(a) * b;
+
+    const auto low = static_cast<std::uint64_t>(product);
+    const auto high = static_cast<std::uint64_t>(product >> 64);
+    const std::uint64_t high_high = high >> 32;
+    const std::uint64_t high_low = high & epsilon;
+
+    std::uint64_t t0 = low - high_high;
+    t0 -= (low < high_high) ? epsilon : 0;
+
+    const std::uint64_t t1 = high_low * epsilon;
+
+    std::uint64_t result = t0 + t1;
+    result += (result < t1) ? epsilon : 0;
+
+    return (result >= modulus) ? result - modulus : result;
+}
+
+std::uint64_t pow_mod(std::uint64_t base, std::uint64_t exponent)
+{
+    std::uint64_t result = 1;
+    for (; exponent != 0; exponent >>= 1, base = mul(base, base))
+        if (exponent & 1)
+            result = mul(result, base);
+
+    return result;
+}
+
+/*
+ * roots[half + j] = w^j for j < half, where w is a primitive root of unity of degree 2 * half,
+ * for all half from 1 to size / 2. Tables for smaller sizes are prefixes of the table for a larger
+ * one, so a single table is kept for all multiplications and only grows
+ */
+std::vector<std::uint64_t> compute_roots_of_unity(std::size_t size, bool inverse)
+{
+    std::vector<std::uint64_t> roots(size);
+
+    for (std::size_t half = 1; half < size; half *= 2)
+    {
+        std::uint64_t w = pow_mod(generator, (modulus - 1) / (2 * half));
+        if (inverse)
+            w = pow_mod(w, modulus - 2);
+
+        roots[half] = 1;
+        for (std::size_t j = 1; j != half; ++j)
+            roots[half + j] = mul(roots[half + j - 1], w);
+    }
+
+    return roots;
+}
+
+using Roots = std::shared_ptr<const std::vector<std::uint64_t>>;
+
+Roots roots_of_unity(std::size_t size, bool inverse)
+{
+    static std::mutex mutex;
+    static Roots tables[2];
+
+    std::lock_guard lock{mutex};
+
+    // a table being used by other threads is kept alive by their copies of the pointer
+    auto &table = tables[inverse];
+    if (!table || table->size() < size)
+        table = std::make_shared<const std::vector<std::uint64_t>>(
+            compute_roots_of_unity(std::max<std::size_t>(size, 2), inverse));
+
+    return table;
+}
+
+/*
+ * Calls butterfly(j, j + half, half + j) for j from [0; half) splitting the range between
+ * threads evenly
+ */
+template<typename Butterfly>
+void run_stage(std::size_t half, unsigned n_threads, Butterfly butterfly)
+{
+    auto run = [=](std::size_t first, std::size_t last)
+    {
+        for (std::size_t j = first; j != last; ++j)
+            butterfly(j, j + half, half + j);
+    };
+
+    if (n_threads <= 1 || half < min_parallel_butterflies)
+    {
+        run(0, half);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i != n_threads; ++i)
+        threads.emplace_back(run, half * i / n_threads, half * (i + 1) / n_threads);
+
+    run(0, half / n_threads);
+
+    for (auto &thread : threads)
+        thread.join();
+}
+
+/*
+ * Runs f on both halves of a, in parallel while there are threads left. Transforms go depth first,
+ * so that all stages of small blocks are done while a block is in cache
+ */
+template<typename F>
+void for_halves(std::span<std::uint64_t> a, unsigned n_threads, F f)
+{
+    const std::size_t half = a.size() / 2;
+
+    if (n_threads <= 1)
+    {
+        f(a.first(half), 1);
+        f(a.last(half), 1);
+        return;
+    }
+
+    const unsigned left_threads = n_threads / 2;
+
+    auto left = std::async(std::launch::async, f, a.first(half), left_threads);
+    f(a.last(half), n_threads - left_threads);
+    left.get();
+}
+
+// decimation in frequency: natural order of coefficients, bit reversed order of values
+void forward_transform(std::span<std::uint64_t> a, const std::vector<std::uint64_t> &roots,
+                       unsigned n_threads)
+{
+    if (a.size() <= cached_block_size)
+    {
+        for (std::size_t half = a.size() / 2; half >= 1; half /= 2)
+            for (std::size_t begin = 0; begin != a.size(); begin += 2 * half)
+                for (std::size_t j = 0; j != half; ++j)
+                {
+                    const std::uint64_t u = a[begin + j], v = a[begin + j + half];
+                    a[begin + j] = add(u, v);
+                    a[begin + j + half] = mul(sub(u, v), roots[half + j]);
+                }
+
+        return;
+    }
+
+    run_stage(a.size() / 2, n_threads, [&](std::size_t i, std::size_t k, std::size_t w)
+    {
+        const std::uint64_t u = a[i], v = a[k];
+        a[i] = add(u, v);
+        a[k] = mul(sub(u, v), roots[w]);
+    });
+
+    for_halves(a, n_threads, [&](std::span<std::uint64_t> half, unsigned threads)
+    {
+        forward_transform(half, roots, threads);
+    });
+}
+
+// decimation in time: bit reversed order of values, natural order of coefficients
+void inverse_transform(std::span<std::uint64_t> a, const std::vector<std::uint64_t> &roots,
+                       unsigned n_threads)
+{
+    if (a.size() <= cached_block_size)
+    {
+        for (std::size_t half = 1; half < a.size(); half *= 2)
+            for (std::size_t begin = 0; begin != a.size(); begin += 2 * half)
+                for (std::size_t j = 0; j != half; ++j)
+                {
+                    const std::uint64_t u = a[begin + j];
+                    const std::uint64_t v = mul(a[begin + j + half], roots[half + j]);
+                    a[begin + j] = add(u, v);
+                    a[begin + j + half] = sub(u, v);
+                }
+
+        return;
+    }
+
+    for_halves(a, n_threads, [&](std::span<std::uint64_t> half, unsigned threads)
+    {
+        inverse_transform(half, roots, threads);
+    });
+
+    run_stage(a.size() / 2, n_threads, [&](std::size_t i, std::size_t k, std::size_t w)
+    {
+        const std::uint64_t u = a[i], v = mul(a[k], roots[w]);
+        a[i] = add(u, v);
+        a[k] = sub(u, v);
+    });
+}
+
+std::vector<std::uint64_t> to_digits(const cpp_int &x, std::size_t size)
+{
+    const auto &backend = x.backend();
+
+    std::vector<std::uint64_t> digits(size);
+    for (std::size_t i = 0; i != backend.size(); ++i)
+        for (unsigned d = 0; d != digits_per_limb; ++d)
+            digits[i * digits_per_limb + d] = (backend.limbs()[i] >> (d * digit_bits)) & 0xFFFF;
+
+    return digits;
+}
+
+} // unnamed namespace
+
+cpp_int ntt_multiply(const cpp_int &a, const cpp_int &b, unsigned n_threads)
+{
+    if (a.is_zero() || b.is_zero())
+        return 0;
+
+    const std::size_t n_limbs = a.backend().size() + b.backend().size();
+    const std::size_t size = std::bit_ceil(n_limbs * digits_per_limb);
+
+    const auto roots = roots_of_unity(size, false);
+
+    auto a_digits = to_digits(a, size);
+    forward_transform(a_digits, *roots, n_threads);
+
+    if (&a == &b)
+    {
+        for (auto &x : a_digits)
+            x = mul(x, x);
+    }
+    else
+    {
+        auto b_digits = to_digits(b, size);
+        forward_transform(b_digits, *roots, n_threads);
+
+        for (std::size_t i = 0; i != size; ++i)
+            a_digits[i] = mul(a_digits[i], b_digits[i]);
+    }
+
+    inverse_transform(a_digits, *roots_of_unity(size, true), n_threads);
+
+    const std::uint64_t size_inverse = pow_mod(size, modulus - 2);
+    for (auto &x : a_digits)
+        x = mul(x, size_inverse);
+
+    cpp_int product;
+    auto &backend = product.backend();
+    backend.resize(n_limbs, n_limbs);
+
+    // every coefficient is less than 2^32 * size, so carries fit in 64 bits
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i != n_limbs; ++i)
+    {
+        limb_type limb = 0;
+        for (unsigned d = 0; d != digits_per_limb; ++d)
+        {
+            carry += a_digits[i * digits_per_limb + d];
+            limb |= static_cast<limb_type>(carry & 0xFFFF) << (d * digit_bits);
+            carry >>= digit_bits;
+        }
+
+        backend.limbs()[i] = limb;
+    }
+
+    backend.normalize();
+    backend.sign(a.sign() != b.sign());
+
+    return product;
+}
+
+// count limbs of x starting from limb first
+static cpp_int limb_slice(const cpp_int &x, std::size_t first, std::size_t count)
+{
+    const auto &backend = x.backend();
+    count = std::min(count, backend.size() - first);
+
+    cpp_int slice;
+    slice.backend().resize(count, count);
+    std::memcpy(slice.backend().limbs(), backend.limbs() + first, count * sizeof(limb_type));
+    slice.backend().normalize();
+
+    return slice;
+}
+
+// cpp_int multiplies by the schoolbook method, which is linear in the longer operand, below it
+static constexpr std::size_t karatsuba_cutoff = 40;
+
+// adds x to limbs starting from limb first; the sum must fit in limbs
+static void add_limbs(std::span<limb_type> limbs, std::size_t first, const cpp_int &x)
+{
+    const auto &backend = x.backend();
+
+    uint128 carry = 0;
+    std::size_t i = 0;
+    for (; i != backend.size(); ++i)
+    {
+        carry += static_cast<uint128>(limbs[first + i]) + backend.limbs()[i];
+        limbs[first + i] = static_cast<limb_type>(carry);
+        carry >>= 64;
+    }
+
+    for (; carry != 0; ++i)
+    {
+        carry += limbs[first + i];
+        limbs[first + i] = static_cast<limb_type>(carry);
+        carry >>= 64;
+    }
+}
+
+cpp_int multiply(const cpp_int &a, const cpp_int &b, unsigned n_threads)
+{
+    const bool a_is_longer = a.backend().size() >= b.backend().size();
+    const cpp_int &longer = a_is_longer ? a : b;
+    const cpp_int &shorter = a_is_longer ? b : a;
+
+    const std::size_t long_size = longer.backend().size();
+    const std::size_t short_size = shorter.backend().size();
+
+    if (short_size >= ntt_multiplication_threshold)
+        return ntt_multiply(a, b, n_threads);
+    else if (short_size < karatsuba_cutoff || long_size < 2 * short_size)
+        return a * b;
+
+    /*
+     * Karatsuba of cpp_int is slow for operands of different lengths, so the longer one is
+     * multiplied by pieces of the length of the shorter one. Pieces are added to limbs of the
+     * product at their offsets, which keeps the sum linear in the length of the product
+     */
+    const std::size_t n_limbs = long_size + short_size;
+
+    cpp_int product;
+    auto &backend = product.backend();
+    backend.resize(n_limbs, n_limbs);
+
+    const std::span<limb_type> limbs{backend.limbs(), n_limbs};
+    std::ranges::fill(limbs, 0);
+
+    const cpp_int multiplier = abs(shorter);
+    for (std::size_t first = 0; first < long_size; first += short_size)
+        add_limbs(limbs, first, limb_slice(longer, first, short_size) * multiplier);
+
+    backend.normalize();
+    backend.sign(a.sign() * b.sign() < 0);
+
+    return product;
+}
+
+static std::size_t bit_length(const cpp_int &x) { return boost::multiprecision::msb(x) + 1; }
+
+/*
+ * 2^(2n) / b for b of exactly n bits with an error of a few units. The reciprocal of the upper
+ * half of bits of b is refined by one Newton's iteration y + y * (2^(2n) - b * y) / 2^(2n), which
+ * doubles the number of correct bits
+ */
+static cpp_int reciprocal(const cpp_int &b, std::size_t n, unsigned n_threads)
+{
+    constexpr std::size_t guard_bits = 8;
+
+    if (n <= reciprocal_base_bits)
+        return (cpp_int{1} << (2 * n)) / b;
+
+    const std::size_t h = n / 2 + guard_bits;
+
+    const cpp_int y = reciprocal(b >> (n - h), h, n_threads) << (n - h);
+    const cpp_int error = (cpp_int{1} << (2 * n)) - multiply(b, y, n_threads);
+
+    const cpp_int correction = multiply(y, abs(error), n_threads) >> (2 * n);
+
+    if (error >= 0)
+        return y + correction;
+    else
+        return y - correction;
+}
+
+cpp_int newton_divide(const cpp_int &a, const cpp_int &b, unsigned n_threads)
+{
+    if (a < b)
+        return 0;
+
+    const std::size_t N = bit_length(a);
+    const std::size_t M = bit_length(b);
+
+    // the reciprocal must have at least as many bits as the quotient
+    const std::size_t n = std::max(M, N - M) + 1;
+
+    const cpp_int y = reciprocal(b << (n - M), n, n_threads);
+
+    cpp_int quotient = multiply(a, y, n_threads) >> (n + M);
+    cpp_int remainder = a - multiply(quotient, b, n_threads);
+
+    for (; remainder < 0; remainder += b)
+        --quotient;
+    for (; remainder >= b; remainder -= b)
+        ++quotient;
+
+    return quotient;
+}
+
+cpp_int divide(const cpp_int &a, const cpp_int &b, unsigned n_threads)
+{
+    if (a.sign() < 0 || b.sign() <= 0)
+        return a / b;
+
+    const std::size_t a_limbs = a.backend().size();
+    const std::size_t b_limbs = b.backend().size();
+
+    if (a_limbs < b_limbs ||
+        std::min(b_limbs, a_limbs - b_limbs) < newton_division_threshold)
+        return a / b;
+
+    return newton_divide(a, b, n_threads);
+}
+
+cpp_int power(cpp_int base, std::size_t exponent, unsigned n_threads)
+{
+    // the first factor is taken as it is, since multiplication by 1 is not free
+    std::optional<cpp_int> result;
+    for (; exponent != 0; exponent >>= 1)
+    {
+        if (exponent & 1)
+            result = result ? multiply(*result, base, n_threads) : base;
+        if (exponent > 1)
+            base = multiply(base, base, n_threads);
+    }
+
+    return result.value_or(1);
+}
+
+} // namespace parallel
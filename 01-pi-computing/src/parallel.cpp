@@ -1,89 +1,615 @@
 #include <cstddef>
 #include <cstdlib>
+#include <cstdint>
 #include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
 #include <iomanip>
 #include <limits>
 #include <chrono>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <functional>
+#include <span>
+#include <future>
+#include <filesystem>
+#include <system_error>
 
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
 
 #include "pi_computation.hpp"
+#include "chudnovsky.hpp"
+#include "bbp_digits.hpp"
+#include "partition.hpp"
+#include "wire_format.hpp"
+#include "checkpoint.hpp"
+#include "verification.hpp"
 #include "program_options.hpp"
 
-using boost::multiprecision::cpp_rational;
 using boost::multiprecision::cpp_dec_float_50;
 
-int main(int argc, char *argv[])
+struct Transfer_Stats
 {
-    boost::mpi::environment env{argc, argv};
-    boost::mpi::communicator world;
+    std::size_t bytes_sent = 0;
+    std::size_t bytes_received = 0;
+    double encoding_time = 0; // ms
+    double decoding_time = 0; // ms
+};
 
-    auto [desc, vm] = parallel::set_program_options(argc, argv,
-                                                    "Set the number of iterations per process");
+template<typename Sum>
+static void send_sum(const boost::mpi::communicator &world, int dest, int tag, const Sum &sum,
+                     Transfer_Stats &stats)
+{
+    using ms = std::chrono::duration<double, std::milli>;
 
-    int rank = world.rank();
+    auto start = std::chrono::high_resolution_clock::now();
 
-    if (vm.count("help"))
-    {
-        if (rank == 0)
-            std::cout << desc << std::endl;
+    parallel::Wire_Buffer buffer;
+    parallel::encode(sum, buffer);
 
-        return 0;
-    }
+    stats.encoding_time += ms{std::chrono::high_resolution_clock::now() - start}.count();
+    stats.bytes_sent += buffer.size() * sizeof(buffer[0]);
 
-    std::size_t per_process;
-    if (vm.count("n-iterations"))
-        per_process = vm["n-iterations"].as<std::size_t>();
-    else
-    {
-        if (rank == 0)
-            std::cout << "The number of iterations not set. Abort" << std::endl;
+    world.send(dest, tag, buffer.data(), buffer.size());
+}
 
-        return 0;
-    }
+template<typename Sum>
+static Sum recv_sum(const boost::mpi::communicator &world, int source, int tag,
+                    Transfer_Stats &stats)
+{
+    using ms = std::chrono::duration<double, std::milli>;
+
+    auto status = world.probe(source, tag);
+
+    parallel::Wire_Buffer buffer(*status.count<std::uint64_t>());
+    world.recv(source, tag, buffer.data(), buffer.size());
+
+    stats.bytes_received += buffer.size() * sizeof(buffer[0]);
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    std::size_t from = rank * per_process;
-    std::size_t to = from + per_process;
+    Sum sum;
+    std::size_t position = 0;
+    parallel::decode(buffer, position, sum);
 
-    cpp_rational pi_part = parallel::compute_part_of_pi_series(from, to);
+    stats.decoding_time += ms{std::chrono::high_resolution_clock::now() - start}.count();
 
+    return sum;
+}
+
+/*
+ * Sums partial sums of all nodes on node 0 by a binary tree: node rank receives the sum of the
+ * ranges of nodes [rank + shift; rank + 2 * shift) and appends it to its own range, so ranges
+ * stay contiguous. Returns true on node 0 only
+ */
+template<typename Sum>
+static bool reduce_to_root(const boost::mpi::communicator &world, Sum &pi_part,
+                           Transfer_Stats &stats)
+{
     constexpr int tag = 0;
 
-    int size = world.size();
-    unsigned current_size = size;
+    int rank = world.rank();
+    unsigned current_size = world.size();
     unsigned current_rank = rank;
     for (int shift = 1; current_size > 1; shift *= 2)
     {
         if (current_rank % 2)
         {
-            world.send(rank - shift, tag, pi_part);
-            return 0;
+            send_sum(world, rank - shift, tag, pi_part, stats);
+            return false;
         }
         else if (current_rank < current_size - 1)
-        {
-            cpp_rational another_pi_part;
-            world.recv(rank + shift, tag, another_pi_part);
-
-            pi_part += another_pi_part;
-        }
+            pi_part += recv_sum<Sum>(world, rank + shift, tag, stats);
 
         std::div_t res = std::div(current_size, 2);
         current_size = res.rem ? 1 + res.quot : res.quot;
         current_rank /= 2;
     }
 
+    return true;
+}
+
+/*
+ * Sums ranges of terms of a node splitting the list of ranges in halves as terms are split. Threads
+ * are shared between halves the same way, and a single range gets all threads that are left
+ */
+template<typename Sum, typename Splitting>
+static Sum sum_ranges(std::span<const parallel::Term_Range> ranges, unsigned n_threads,
+                      Splitting splitting)
+{
+    if (ranges.empty())
+        return Sum{};
+    else if (ranges.size() == 1)
+        return splitting(ranges.front(), n_threads);
+
+    const std::size_t middle = ranges.size() / 2;
+
+    if (n_threads <= 1)
+    {
+        Sum sum = sum_ranges<Sum>(ranges.first(middle), 1, splitting);
+        sum += sum_ranges<Sum>(ranges.subspan(middle), 1, splitting);
+
+        return sum;
+    }
+
+    const unsigned left_threads = n_threads / 2;
+
+    auto left = std::async(std::launch::async, [=]
+    {
+        return sum_ranges<Sum>(ranges.first(middle), left_threads, splitting);
+    });
+    Sum right = sum_ranges<Sum>(ranges.subspan(middle), n_threads - left_threads, splitting);
+
+    Sum sum = left.get();
+    sum += right;
+
+    return sum;
+}
+
+struct Checkpoint_Stats
+{
+    std::size_t n_checkpoints = 0;
+    std::size_t bytes_written = 0;
+    double writing_time = 0; // ms
+    std::size_t n_terms_resumed = 0;
+};
+
+// the first portion of terms between checkpoints before its time is known
+static constexpr std::size_t initial_portion = 1024;
+
+/*
+ * Without --checkpoint-dir sums all terms of a node at once. Otherwise sums them by portions
+ * taking about --checkpoint-interval seconds each and saves the sum after every portion. Portions
+ * are added to the sum in order, so Chudnovsky triples stay contiguous
+ */
+template<typename Sum, typename Splitting>
+static Sum sum_with_checkpoints(const boost::mpi::communicator &world,
+                                const parallel::po::variables_map &vm,
+                                const parallel::Run_Key &key,
+                                std::span<const parallel::Term_Range> ranges, Splitting splitting,
+                                Checkpoint_Stats &stats)
+{
+    using ms = std::chrono::duration<double, std::milli>;
+
+    const auto n_threads = vm["threads-per-rank"].as<unsigned>();
+
+    if (!vm.count("checkpoint-dir"))
+        return sum_ranges<Sum>(ranges, n_threads, splitting);
+
+    const auto path = parallel::checkpoint_path(vm["checkpoint-dir"].as<std::string>(),
+                                                world.rank());
+    const double interval = vm["checkpoint-interval"].as<double>() * 1000;
+
+    std::size_t n_local_terms = 0;
+    for (auto &range : ranges)
+        n_local_terms += range.size();
+
+    Sum sum;
+    std::size_t n_terms_done = 0;
+    if (vm.count("resume"))
+    {
+        if (auto n_terms = parallel::load_checkpoint(path, key, sum))
+            n_terms_done = stats.n_terms_resumed = *n_terms;
+    }
+
+    for (std::size_t portion = initial_portion; n_terms_done < n_local_terms; )
+    {
+        const std::size_t count = std::min(portion, n_local_terms - n_terms_done);
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        auto slice = parallel::slice_terms(ranges, n_terms_done, count);
+        sum.add(sum_ranges<Sum>(slice, n_threads, splitting), n_threads);
+        n_terms_done += count;
+
+        auto finish = std::chrono::high_resolution_clock::now();
+
+        stats.bytes_written += parallel::save_checkpoint(path, key, n_terms_done, sum);
+        stats.writing_time += ms{std::chrono::high_resolution_clock::now() - finish}.count();
+        ++stats.n_checkpoints;
+
+        /*
+         * Every portion is added to the whole sum, so portions never shrink: otherwise an interval
+         * shorter than one addition would turn into a checkpoint after every term
+         */
+        const double elapsed = std::max(ms{finish - start}.count(), 1.0);
+        portion = std::clamp<std::size_t>(count * interval / elapsed, portion, 4 * portion);
+    }
+
+    return sum;
+}
+
+static void print_checkpoint_stats(const boost::mpi::communicator &world, double compute_time,
+                                   const Checkpoint_Stats &stats)
+{
+    std::vector<double> all_times, all_writing;
+    std::vector<std::size_t> all_checkpoints, all_bytes, all_resumed;
+    boost::mpi::gather(world, compute_time, all_times, 0);
+    boost::mpi::gather(world, stats.writing_time, all_writing, 0);
+    boost::mpi::gather(world, stats.n_checkpoints, all_checkpoints, 0);
+    boost::mpi::gather(world, stats.bytes_written, all_bytes, 0);
+    boost::mpi::gather(world, stats.n_terms_resumed, all_resumed, 0);
+
+    if (world.rank() != 0)
+        return;
+
+    for (int rank = 0; rank != world.size(); ++rank)
+    {
+        std::cout << "Node " << rank << ": resumed after " << all_resumed[rank] << " terms; "
+                  << all_checkpoints[rank] << " checkpoints of " << all_bytes[rank]
+                  << " bytes in total, writing took " << all_writing[rank] << " ms ("
+                  << 100 * all_writing[rank] / all_times[rank] << "% of computing)" << std::endl;
+    }
+}
+
+static void print_rank_times(const boost::mpi::communicator &world, std::size_t n_terms,
+                             double compute_time, const Transfer_Stats &stats)
+{
+    std::vector<std::size_t> all_terms;
+    std::vector<double> all_times;
+    std::vector<std::size_t> all_sent, all_received;
+    std::vector<double> all_encoding, all_decoding;
+    boost::mpi::gather(world, n_terms, all_terms, 0);
+    boost::mpi::gather(world, compute_time, all_times, 0);
+    boost::mpi::gather(world, stats.bytes_sent, all_sent, 0);
+    boost::mpi::gather(world, stats.bytes_received, all_received, 0);
+    boost::mpi::gather(world, stats.encoding_time, all_encoding, 0);
+    boost::mpi::gather(world, stats.decoding_time, all_decoding, 0);
+
+    if (world.rank() != 0)
+        return;
+
+    double max_time = 0, total_time = 0;
+    for (int rank = 0; rank != world.size(); ++rank)
+    {
+        std::cout << "Node " << rank << ": " << all_terms[rank] << " terms, computing took "
+                  << all_times[rank] << " ms; sent " << all_sent[rank] << " bytes, encoding took "
+                  << all_encoding[rank] << " ms; received " << all_received[rank]
+                  << " bytes, decoding took " << all_decoding[rank] << " ms" << std::endl;
+
+        max_time = std::max(max_time, all_times[rank]);
+        total_time += all_times[rank];
+    }
+
+    // how much longer the slowest node works than an average one
+    std::cout << "Imbalance: " << max_time / (total_time / world.size()) << std::endl;
+}
+
+// decimal places of the sum of n_terms terms the bound on the rest of the series guarantees
+template<typename Sum>
+static std::size_t guaranteed_digits(std::size_t n_terms)
+{
+    if constexpr (std::is_same_v<Sum, parallel::BBP_Sum>)
+        return parallel::bbp_guaranteed_digits(n_terms);
+    else
+        return parallel::chudnovsky_guaranteed_digits(n_terms);
+}
+
+// returns false if digits differ from the reference given by --verify
+template<typename Sum>
+static bool print_pi(const boost::mpi::communicator &world, const parallel::po::variables_map &vm,
+                     Sum pi_part, std::size_t n_terms,
+                     std::chrono::high_resolution_clock::time_point start)
+{
+    if (vm.count("digits"))
+    {
+        const auto digits = vm["digits"].as<std::size_t>();
+        const auto output = vm["output"].as<std::string>();
+
+        auto pi = parallel::pi_digits(std::move(pi_part), n_terms, digits,
+                                      vm["threads-per-rank"].as<unsigned>());
+
+        auto finish = std::chrono::high_resolution_clock::now();
+
+        bool verified = true;
+        if (vm.count("verify"))
+            verified = parallel::verify_digits(std::cout, pi, digits,
+                                               vm["verify"].as<std::string>());
+
+        if (output.empty() && !vm.count("verify"))
+            parallel::write_digits(std::cout, pi, digits);
+        else if (!output.empty())
+        {
+            std::ofstream out{output};
+            if (!out.is_open())
+                throw std::runtime_error{"Could not open file " + output};
+
+            parallel::write_digits(out, pi, digits);
+        }
+
+        // pi_digits() adds terms until all digits are known for sure
+        std::cout << "Guaranteed correct decimal places: " << digits << std::endl;
+
+        using ms = std::chrono::milliseconds;
+        auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
+        std::cout << "Parallel computing on " << world.size() << " nodes took: " << exec_time
+                  << " ms" << std::endl;
+
+        return verified;
+    }
+
     auto finish = std::chrono::high_resolution_clock::now();
 
     constexpr auto precision = std::numeric_limits<cpp_dec_float_50>::max_digits10;
     std::cout << std::setprecision(precision) << parallel::ratio_to_float(pi_part) << std::endl;
 
+    // the last digits of cpp_dec_float_50 are not exact whatever the number of terms
+    constexpr std::size_t float_digits = std::numeric_limits<cpp_dec_float_50>::digits10 - 1;
+    std::cout << "Guaranteed correct decimal places: "
+              << std::min(guaranteed_digits<Sum>(n_terms), float_digits) << std::endl;
+
     using ms = std::chrono::milliseconds;
     auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
-    std::cout << "Parallel computing on " << size << " nodes took: " << exec_time << " ms"
+    std::cout << "Parallel computing on " << world.size() << " nodes took: " << exec_time << " ms"
               << std::endl;
 
-    return 0;
+    return true;
+}
+
+/*
+ * Digits are computed by chunks of hex_chunk_digits. Every node sums its own block of terms of each
+ * chunk, so it only keeps one number per chunk, and the fractional parts are added by reduction
+ */
+static void print_hex_digits(const boost::mpi::communicator &world, std::size_t position,
+                             std::size_t n_digits)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const std::size_t n_chunks = (n_digits + parallel::hex_chunk_digits - 1)
+                               / parallel::hex_chunk_digits;
+
+    std::vector<long double> fractions(n_chunks);
+    for (std::size_t chunk = 0; chunk != n_chunks; ++chunk)
+    {
+        const std::size_t chunk_position = position + chunk * parallel::hex_chunk_digits;
+        const std::size_t n_terms = chunk_position + parallel::hex_tail_terms;
+
+        const std::size_t from = n_terms * world.rank() / world.size();
+        const std::size_t to = n_terms * (world.rank() + 1) / world.size();
+
+        fractions[chunk] = parallel::bbp_hex_fraction(chunk_position, from, to);
+    }
+
+    std::vector<long double> sums(n_chunks);
+    boost::mpi::reduce(world, fractions.data(), n_chunks, sums.data(), std::plus<long double>{},
+                       0);
+
+    if (world.rank() != 0)
+        return;
+
+    auto finish = std::chrono::high_resolution_clock::now();
+
+    std::string hex;
+    for (std::size_t chunk = 0; chunk != n_chunks; ++chunk)
+        hex += parallel::hex_digits(sums[chunk], std::min(parallel::hex_chunk_digits,
+                                                          n_digits - hex.size()));
+
+    std::cout << hex << std::endl;
+
+    using ms = std::chrono::milliseconds;
+    auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
+    std::cout << "Parallel computing on " << world.size() << " nodes took: " << exec_time << " ms"
+              << std::endl;
+}
+
+// returns false if digits differ from the reference given by --verify
+template<typename Sum, typename Splitting>
+static bool compute_pi(const boost::mpi::communicator &world,
+                       const parallel::po::variables_map &vm, const parallel::Run_Key &key,
+                       const std::vector<parallel::Term_Range> &ranges, std::size_t n_terms,
+                       Splitting splitting)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Checkpoint_Stats checkpoint_stats;
+    Sum pi_part = sum_with_checkpoints<Sum>(world, vm, key, ranges, splitting, checkpoint_stats);
+
+    using ms = std::chrono::duration<double, std::milli>;
+    auto compute_time = ms{std::chrono::high_resolution_clock::now() - start}.count();
+
+    Transfer_Stats stats;
+    bool verified = true;
+    if (reduce_to_root(world, pi_part, stats))
+        verified = print_pi(world, vm, std::move(pi_part), n_terms, start);
+
+    if (vm.count("rank-times"))
+    {
+        std::size_t n_local_terms = 0;
+        for (auto &range : ranges)
+            n_local_terms += range.size();
+
+        print_rank_times(world, n_local_terms, compute_time, stats);
+    }
+
+    if (vm.count("checkpoint-dir"))
+        print_checkpoint_stats(world, compute_time, checkpoint_stats);
+
+    return verified;
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    // worker threads only compute, and MPI is called by the main thread of every process
+    boost::mpi::environment env{argc, argv, boost::mpi::threading::funneled};
+    boost::mpi::communicator world;
+
+    po::options_description parallel_desc;
+    parallel_desc.add_options()
+        ("partition", po::value<std::string>()->default_value("block"),
+         "Choose how terms are distributed between processes:\n"
+         "  - block: equal contiguous ranges;\n"
+         "  - cyclic: term k goes to process k mod N;\n"
+         "  - block-cyclic: blocks of block-size terms are dealt to processes in turn;\n"
+         "  - balanced: contiguous ranges of equal cost estimated by lengths of operands")
+        ("block-size", po::value<std::size_t>()->default_value(256),
+         "Set the number of terms in a block of block-cyclic partition")
+        ("rank-times", "Print the time every process spent on its terms and on encoding its "
+         "messages")
+        ("checkpoint-dir", po::value<std::string>(),
+         "Set the directory every process saves its partial sum to after every portion of terms")
+        ("checkpoint-interval", po::value<double>()->default_value(600),
+         "Set the time in seconds a process sums terms between checkpoints")
+        ("resume", "Continue the run from checkpoints in checkpoint-dir");
+
+    auto [desc, vm] = parallel::set_program_options(argc, argv,
+                                                    "Set the number of iterations per process",
+                                                    parallel_desc);
+
+    int rank = world.rank();
+
+    if (vm.count("help"))
+    {
+        if (rank == 0)
+            std::cout << desc << std::endl;
+
+        return 0;
+    }
+
+    if (vm["threads-per-rank"].as<unsigned>() > 1
+        && env.thread_level() < boost::mpi::threading::funneled)
+    {
+        if (rank == 0)
+            std::cout << "MPI does not support threads in processes. Abort" << std::endl;
+
+        return 1;
+    }
+
+    const auto engine = vm["engine"].as<std::string>();
+    if (engine != "bbp" && engine != "chudnovsky")
+    {
+        if (rank == 0)
+            std::cout << "Unsupported engine. Abort" << std::endl;
+
+        return 0;
+    }
+
+    if (vm.count("hex-position"))
+    {
+        print_hex_digits(world, vm["hex-position"].as<std::size_t>(),
+                         vm["hex-digits"].as<std::size_t>());
+        return 0;
+    }
+
+    const auto partition = parallel::to_partition(vm["partition"].as<std::string>());
+    if (!partition)
+    {
+        if (rank == 0)
+            std::cout << "Unsupported partition. Abort" << std::endl;
+
+        return 0;
+    }
+
+    // Chudnovsky triples can only be combined in order of their ranges
+    if (engine == "chudnovsky" && !parallel::is_contiguous(*partition))
+    {
+        if (rank == 0)
+            std::cout << "The chudnovsky engine requires block or balanced partition. Abort"
+                      << std::endl;
+
+        return 0;
+    }
+
+    int size = world.size();
+
+    std::size_t n_terms;
+    if (vm.count("digits"))
+    {
+        const auto digits = vm["digits"].as<std::size_t>();
+        n_terms = (engine == "bbp") ? parallel::bbp_terms_for_digits(digits)
+                                    : parallel::chudnovsky_terms_for_digits(digits);
+    }
+    else if (vm.count("n-iterations"))
+        n_terms = vm["n-iterations"].as<std::size_t>() * size;
+    else
+    {
+        if (rank == 0)
+            std::cout << "The number of iterations not set. Abort" << std::endl;
+
+        return 0;
+    }
+
+    // the sum of the Chudnovsky series is the divisor of pi
+    if (engine == "chudnovsky" && n_terms == 0)
+    {
+        if (rank == 0)
+            std::cout << "The chudnovsky engine requires at least one iteration. Abort"
+                      << std::endl;
+
+        return 1;
+    }
+
+    if (vm.count("resume") && !vm.count("checkpoint-dir"))
+    {
+        if (rank == 0)
+            std::cout << "Resuming requires the checkpoint directory. Abort" << std::endl;
+
+        return 0;
+    }
+
+    if (vm["checkpoint-interval"].as<double>() <= 0)
+    {
+        if (rank == 0)
+            std::cout << "The checkpoint interval must be positive. Abort" << std::endl;
+
+        return 0;
+    }
+
+    if (vm.count("checkpoint-dir"))
+    {
+        // every node may have its own local directory
+        const std::filesystem::path dir = vm["checkpoint-dir"].as<std::string>();
+
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        if (!std::filesystem::is_directory(dir))
+            throw std::runtime_error{"Could not create directory " + dir.string()};
+    }
+
+    if (vm.count("verify") && !vm.count("digits"))
+    {
+        if (rank == 0)
+            std::cout << "Verification requires the number of digits. Abort" << std::endl;
+
+        return 1;
+    }
+
+    const auto block_size = vm["block-size"].as<std::size_t>();
+
+    // checkpoints are only resumed by the run with the same terms on every node
+    const parallel::Run_Key key{engine == "bbp" ? 0u : 1u, static_cast<std::uint64_t>(*partition),
+                                n_terms, block_size, static_cast<std::uint64_t>(rank),
+                                static_cast<std::uint64_t>(size)};
+
+    bool verified;
+    if (engine == "bbp")
+    {
+        auto ranges = parallel::partition_terms(*partition, n_terms, rank, size, block_size,
+                                                parallel::bbp_cost);
+
+        verified = compute_pi<parallel::BBP_Sum>(world, vm, key, ranges, n_terms,
+                                                 [](const auto &range, unsigned n_threads)
+        {
+            return parallel::bbp_binary_splitting(range.from, range.to, range.stride, n_threads);
+        });
+    }
+    else
+    {
+        auto ranges = parallel::partition_terms(*partition, n_terms, rank, size, block_size,
+                                                parallel::chudnovsky_cost);
+
+        verified = compute_pi<parallel::Chudnovsky_Sum>(world, vm, key, ranges, n_terms,
+                                                        [](const auto &range, unsigned n_threads)
+        {
+            return parallel::chudnovsky_binary_splitting(range.from, range.to, n_threads);
+        });
+    }
+
+    return verified ? 0 : 1;
 }
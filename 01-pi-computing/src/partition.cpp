@@ -0,0 +1,128 @@
+#include <cstddef>
+#include <cmath>
+#include <numbers>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <optional>
+#include <algorithm>
+
+#include "partition.hpp"
+
+namespace parallel
+{
+
+std::optional<Partition> to_partition(std::string_view name)
+{
+    if (name == "block")
+        return Partition::block;
+    else if (name == "cyclic")
+        return Partition::cyclic;
+    else if (name == "block-cyclic")
+        return Partition::block_cyclic;
+    else if (name == "balanced")
+        return Partition::balanced;
+    else
+        return std::nullopt;
+}
+
+bool is_contiguous(Partition partition)
+{
+    return partition == Partition::block || partition == Partition::balanced;
+}
+
+// log2(n!)
+static double log2_factorial(std::size_t n)
+{
+    return std::lgamma(static_cast<double>(n) + 1) * std::numbers::log2e;
+}
+
+double bbp_cost(std::size_t n)
+{
+    // Q grows by log2(512k^4) bits per term, T also by 4 bits of the power of 16
+    return 13.0 * n + 4 * log2_factorial(n);
+}
+
+double chudnovsky_cost(std::size_t n)
+{
+    // log2(640320^3 / 24 * k^3) bits of Q, log2(72k^3) bits of P and 30 more bits of T
+    return 120.0 * n + 9 * log2_factorial(n);
+}
+
+// the first term of the range of node rank such that all ranges are of the same cost
+static std::size_t balanced_bound(std::size_t n_terms, int rank, int size, const Cost_Model &cost)
+{
+    const double target = cost(n_terms) * rank / size;
+
+    std::size_t lower = 0, upper = n_terms;
+    while (lower < upper)
+    {
+        const std::size_t middle = lower + (upper - lower) / 2;
+        if (cost(middle) < target)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    return lower;
+}
+
+std::vector<Term_Range> partition_terms(Partition partition, std::size_t n_terms, int rank,
+                                        int size, std::size_t block_size, const Cost_Model &cost)
+{
+    switch (partition)
+    {
+        case Partition::block:
+            return {Term_Range{n_terms * rank / size, n_terms * (rank + 1) / size}};
+
+        case Partition::cyclic:
+            return {Term_Range{static_cast<std::size_t>(rank), n_terms,
+                               static_cast<std::size_t>(size)}};
+
+        case Partition::block_cyclic:
+        {
+            std::vector<Term_Range> ranges;
+            for (std::size_t from = rank * block_size; from < n_terms; from += size * block_size)
+                ranges.push_back(Term_Range{from, std::min(from + block_size, n_terms)});
+
+            return ranges;
+        }
+
+        case Partition::balanced:
+            return {Term_Range{balanced_bound(n_terms, rank, size, cost),
+                               balanced_bound(n_terms, rank + 1, size, cost)}};
+    }
+
+    return {};
+}
+
+std::vector<Term_Range> slice_terms(std::span<const Term_Range> ranges, std::size_t first,
+                                    std::size_t count)
+{
+    std::vector<Term_Range> slice;
+    for (auto &range : ranges)
+    {
+        if (count == 0)
+            break;
+
+        const std::size_t size = range.size();
+        if (first >= size)
+        {
+            first -= size;
+            continue;
+        }
+
+        const std::size_t n_taken = std::min(count, size - first);
+        const std::size_t from = range.from + first * range.stride;
+        const std::size_t last = from + (n_taken - 1) * range.stride;
+
+        slice.push_back(Term_Range{from, last + 1, range.stride});
+
+        first = 0;
+        count -= n_taken;
+    }
+
+    return slice;
+}
+
+} // namespace parallel
@@ -1,4 +1,15 @@
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <vector>
+#include <algorithm>
+#include <future>
+
 #include "pi_computation.hpp"
+#include "ntt.hpp"
 
 namespace parallel
 {
@@ -7,24 +18,77 @@ using boost::multiprecision::cpp_rational;
 using boost::multiprecision::cpp_int;
 using boost::multiprecision::cpp_dec_float_50;
 
-cpp_rational compute_part_of_pi_series(std::size_t from, std::size_t to)
+BBP_Sum &BBP_Sum::add(const BBP_Sum &rhs, unsigned n_threads)
 {
-    cpp_rational pi;
+    if (rhs.T == 0)
+        return *this;
+    else if (T == 0)
+        return *this = rhs;
 
-    for (std::size_t k = from; k != to; ++k)
+    // bring both sums to the common denominator Q_1 * Q_2 * 2^max(shift_1, shift_2)
+    if (shift <= rhs.shift)
     {
-        cpp_rational r1{4, 8 * k + 1};
-        cpp_rational r2{-2, 8 * k + 4};
-        cpp_rational r3{-1, 8 * k + 5};
-        cpp_rational r4{-1, 8 * k + 6};
+        T = multiply(T, rhs.Q, n_threads);
+        T <<= rhs.shift - shift;
+        T += multiply(rhs.T, Q, n_threads);
+        shift = rhs.shift;
+    }
+    else
+    {
+        T = (multiply(rhs.T, Q, n_threads) << (shift - rhs.shift)) + multiply(T, rhs.Q, n_threads);
+    }
 
-        cpp_int denom = 1;
-        denom <<= 4 * k;
+    Q = multiply(Q, rhs.Q, n_threads);
+
+    return *this;
+}
+
+cpp_rational BBP_Sum::to_rational() const { return cpp_rational{T, Q << shift}; }
+
+static BBP_Sum bbp_term(std::size_t k)
+{
+    cpp_int K = k;
 
-        pi += (r1 + r2 + r3 + r4) / denom;
+    return BBP_Sum{.T = (120 * K + 151) * K + 47,
+                   .Q = (((512 * K + 1024) * K + 712) * K + 194) * K + 15,
+                   .shift = 4 * k};
+}
+
+BBP_Sum bbp_binary_splitting(std::size_t from, std::size_t to, std::size_t stride,
+                             unsigned n_threads)
+{
+    if (from >= to)
+        return BBP_Sum{};
+
+    const std::size_t n_terms = (to - from - 1) / stride + 1;
+    if (n_terms == 1)
+        return bbp_term(from);
+
+    const std::size_t middle = from + n_terms / 2 * stride;
+
+    if (n_threads <= 1)
+    {
+        BBP_Sum sum = bbp_binary_splitting(from, middle, stride);
+        sum += bbp_binary_splitting(middle, to, stride);
+
+        return sum;
     }
 
-    return pi;
+    const unsigned left_threads = n_threads / 2;
+
+    auto left = std::async(std::launch::async, bbp_binary_splitting,
+                           from, middle, stride, left_threads);
+    BBP_Sum right = bbp_binary_splitting(middle, to, stride, n_threads - left_threads);
+
+    BBP_Sum sum = left.get();
+    sum.add(right, n_threads);
+
+    return sum;
+}
+
+cpp_rational compute_part_of_pi_series(std::size_t from, std::size_t to)
+{
+    return bbp_binary_splitting(from, to).to_rational();
 }
 
 cpp_dec_float_50 ratio_to_float(cpp_rational r)
@@ -35,9 +99,145 @@ cpp_dec_float_50 ratio_to_float(cpp_rational r)
     return num / denom;
 }
 
+cpp_dec_float_50 ratio_to_float(const BBP_Sum &sum)
+{
+    constexpr auto digits = std::numeric_limits<cpp_dec_float_50>::max_digits10;
+
+    const cpp_int scale = boost::multiprecision::pow(cpp_int{10}, digits);
+    const cpp_int scaled = sum.T * scale / (sum.Q << sum.shift);
+
+    return cpp_dec_float_50{scaled} / cpp_dec_float_50{scale};
+}
+
+std::size_t bbp_terms_for_digits(std::size_t digits)
+{
+    // 4 / 16^n < 10^-digits
+    const double log10_16 = 4 * std::numbers::log10e * std::numbers::ln2;
+    return static_cast<std::size_t>(std::ceil((digits + std::log10(4.0)) / log10_16)) + 1;
+}
+
+std::size_t bbp_guaranteed_digits(std::size_t n_terms)
+{
+    const double log10_16 = 4 * std::numbers::log10e * std::numbers::ln2;
+    return static_cast<std::size_t>(std::max(n_terms * log10_16 - std::log10(4.0), 0.0));
+}
+
+cpp_int pi_digits(BBP_Sum sum, std::size_t n_terms, std::size_t digits, unsigned n_threads)
+{
+    const cpp_int scale = power(10, digits, n_threads);
+
+    for (;;)
+    {
+        // the rest of the series after n_terms terms is less than 2^(2 - 4 * n_terms)
+        const std::size_t rest_shift = 4 * n_terms - 2;
+
+        const cpp_int denominator = sum.Q << sum.shift;
+        const cpp_int lower = divide(multiply(sum.T, scale, n_threads), denominator, n_threads);
+        const cpp_int upper_numerator = (sum.T << rest_shift) + denominator;
+        const cpp_int upper = divide(multiply(upper_numerator, scale, n_threads),
+                                     denominator << rest_shift, n_threads);
+
+        if (lower == upper)
+            return lower;
+
+        const std::size_t extra_terms = std::max<std::size_t>(n_terms / 64, 8);
+        sum.add(bbp_binary_splitting(n_terms, n_terms + extra_terms, 1, n_threads), n_threads);
+        n_terms += extra_terms;
+    }
+}
+
+// numbers of up to that many decimal digits are converted by cpp_int::str()
+static constexpr std::size_t str_conversion_digits = 1024;
+
+/*
+ * Passes exactly n_digits decimal digits of x < 10^n_digits padded with zeros on the left to sink
+ * until it returns false. powers[i] = 10^(str_conversion_digits * 2^i)
+ */
+static bool convert_to_decimal(const cpp_int &x, std::size_t n_digits,
+                               const std::vector<cpp_int> &powers, const Digit_Sink &sink)
+{
+    if (n_digits <= str_conversion_digits)
+    {
+        std::string digits = x.str();
+        digits.insert(0, n_digits - digits.size(), '0');
+
+        return sink(digits);
+    }
+
+    std::size_t level = 0;
+    while ((str_conversion_digits << (level + 1)) < n_digits)
+        ++level;
+
+    const std::size_t low_digits = str_conversion_digits << level;
+    const cpp_int high = divide(x, powers[level]);
+
+    if (!convert_to_decimal(high, n_digits - low_digits, powers, sink))
+        return false;
+
+    const cpp_int low = x - multiply(high, powers[level]);
+
+    return convert_to_decimal(low, low_digits, powers, sink);
+}
+
+bool for_each_digit_chunk(const cpp_int &scaled_pi, std::size_t digits, const Digit_Sink &sink)
+{
+    // an upper bound on the number of digits with at least one digit before the point
+    const auto n_bits = (scaled_pi == 0) ? 0 : boost::multiprecision::msb(scaled_pi) + 1;
+    const auto n_digits = std::max(static_cast<std::size_t>(n_bits * std::log10(2.0)) + 1,
+                                   digits + 1);
+
+    std::vector<cpp_int> powers{power(10, str_conversion_digits)};
+    while ((str_conversion_digits << powers.size()) < n_digits)
+        powers.push_back(multiply(powers.back(), powers.back()));
+
+    // position of the decimal point in the padded number
+    const std::size_t point = n_digits - digits;
+    std::size_t position = 0;
+    bool leading_zeros = true;
+
+    return convert_to_decimal(scaled_pi, n_digits, powers, [&](std::string_view chunk)
+    {
+        std::size_t begin = position;
+        position += chunk.size();
+
+        if (leading_zeros)
+        {
+            // the digit right before the point is kept even if it is 0
+            const std::size_t n_zeros = std::min({chunk.find_first_not_of('0'), chunk.size(),
+                                                  point - 1 - std::min(begin, point - 1)});
+            chunk.remove_prefix(n_zeros);
+            begin += n_zeros;
+
+            if (chunk.empty())
+                return true;
+
+            leading_zeros = false;
+        }
+
+        if (digits == 0 || point < begin || begin + chunk.size() <= point)
+            return sink(chunk);
+
+        const std::size_t integer_part = point - begin;
+
+        return (integer_part == 0 || sink(chunk.substr(0, integer_part)))
+               && sink(".") && sink(chunk.substr(integer_part));
+    });
+}
+
+void write_digits(std::ostream &os, const cpp_int &scaled_pi, std::size_t digits)
+{
+    for_each_digit_chunk(scaled_pi, digits, [&os](std::string_view chunk)
+    {
+        os.write(chunk.data(), chunk.size());
+        return true;
+    });
+
+    os.put('\n');
+}
+
 cpp_dec_float_50 compute_pi(std::size_t n_iterations)
 {
-    return ratio_to_float(compute_part_of_pi_series(0, n_iterations));
+    return ratio_to_float(bbp_binary_splitting(0, n_iterations));
 }
 
 } // namespace parallel
@@ -1,18 +1,42 @@
 #include <cstddef>
+#include <string>
 
 #include "program_options.hpp"
 
 namespace parallel
 {
 
-auto set_program_options(int argc, char *argv[], std::string_view n_iter_desc)
+auto set_program_options(int argc, char *argv[], std::string_view n_iter_desc,
+                         const po::options_description &extra_options)
     -> std::pair<po::options_description, po::variables_map>
 {
     po::options_description desc{"Allowed options"};
 
     desc.add_options()
         ("help", "Produce help message")
-        ("n-iterations", po::value<std::size_t>(), n_iter_desc.data());
+        ("n-iterations", po::value<std::size_t>(), n_iter_desc.data())
+        ("digits", po::value<std::size_t>(),
+         "Set the number of decimal places to compute exactly instead of the number of "
+         "iterations")
+        ("output", po::value<std::string>()->default_value(""),
+         "Set the file to write digits to instead of the standard output")
+        ("verify", po::value<std::string>(),
+         "Compare digits with the reference file as they are converted instead of printing them "
+         "and stop at the first mismatch")
+        ("engine", po::value<std::string>()->default_value("bbp"),
+         "Choose the series to sum:\n"
+         "  - bbp: Bailey-Borwein-Plouffe formula, about 1.2 digits per term;\n"
+         "  - chudnovsky: Chudnovsky formula, about 14 digits per term")
+        ("threads-per-rank", po::value<unsigned>()->default_value(1),
+         "Set the number of threads summing terms of a process")
+        ("hex-position", po::value<std::size_t>(),
+         "Compute hexadecimal digits of pi starting right after the given position instead of "
+         "the number of iterations")
+        ("hex-digits", po::value<std::size_t>()->default_value(8),
+         "Set the number of hexadecimal digits to compute");
+
+    for (auto &option : extra_options.options())
+        desc.add(option);
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
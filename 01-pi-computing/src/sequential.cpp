@@ -1,12 +1,116 @@
 #include <cstddef>
 #include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string>
 #include <iomanip>
 #include <limits>
 #include <chrono>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
 
 #include "pi_computation.hpp"
+#include "chudnovsky.hpp"
+#include "bbp_digits.hpp"
+#include "verification.hpp"
 #include "program_options.hpp"
 
+using boost::multiprecision::cpp_dec_float_50;
+
+// decimal places of the sum of n_terms terms the bound on the rest of the series guarantees
+template<typename Sum>
+static std::size_t guaranteed_digits(std::size_t n_terms)
+{
+    if constexpr (std::is_same_v<Sum, parallel::BBP_Sum>)
+        return parallel::bbp_guaranteed_digits(n_terms);
+    else
+        return parallel::chudnovsky_guaranteed_digits(n_terms);
+}
+
+// returns false if digits differ from the reference given by --verify
+template<typename Sum>
+static bool print_pi(const parallel::po::variables_map &vm, Sum sum, std::size_t n_terms,
+                     std::chrono::high_resolution_clock::time_point start)
+{
+    if (vm.count("digits"))
+    {
+        const auto digits = vm["digits"].as<std::size_t>();
+        const auto output = vm["output"].as<std::string>();
+
+        auto pi = parallel::pi_digits(std::move(sum), n_terms, digits,
+                                      vm["threads-per-rank"].as<unsigned>());
+
+        auto finish = std::chrono::high_resolution_clock::now();
+
+        bool verified = true;
+        if (vm.count("verify"))
+            verified = parallel::verify_digits(std::cout, pi, digits,
+                                               vm["verify"].as<std::string>());
+
+        if (output.empty() && !vm.count("verify"))
+            parallel::write_digits(std::cout, pi, digits);
+        else if (!output.empty())
+        {
+            std::ofstream out{output};
+            if (!out.is_open())
+                throw std::runtime_error{"Could not open file " + output};
+
+            parallel::write_digits(out, pi, digits);
+        }
+
+        // pi_digits() adds terms until all digits are known for sure
+        std::cout << "Guaranteed correct decimal places: " << digits << std::endl;
+
+        using ms = std::chrono::milliseconds;
+        auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
+        std::cout << "Sequential computing took: " << exec_time << " ms" << std::endl;
+
+        return verified;
+    }
+
+    auto pi = parallel::ratio_to_float(sum);
+
+    auto finish = std::chrono::high_resolution_clock::now();
+
+    constexpr auto max_precision = std::numeric_limits<cpp_dec_float_50>::max_digits10;
+    std::cout << std::setprecision(max_precision) << pi << std::endl;
+
+    // the last digits of cpp_dec_float_50 are not exact whatever the number of terms
+    constexpr std::size_t float_digits = std::numeric_limits<cpp_dec_float_50>::digits10 - 1;
+    std::cout << "Guaranteed correct decimal places: "
+              << std::min(guaranteed_digits<Sum>(n_terms), float_digits) << std::endl;
+
+    using ms = std::chrono::milliseconds;
+    auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
+    std::cout << "Sequential computing took: " << exec_time << " ms" << std::endl;
+
+    return true;
+}
+
+static void print_hex_digits(std::size_t position, std::size_t n_digits)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::string hex;
+    for (std::size_t chunk_position = position; hex.size() < n_digits;
+         chunk_position += parallel::hex_chunk_digits)
+    {
+        auto fraction = parallel::bbp_hex_fraction(chunk_position, 0,
+                                                   chunk_position + parallel::hex_tail_terms);
+        hex += parallel::hex_digits(fraction, std::min(parallel::hex_chunk_digits,
+                                                       n_digits - hex.size()));
+    }
+
+    auto finish = std::chrono::high_resolution_clock::now();
+
+    std::cout << hex << std::endl;
+
+    using ms = std::chrono::milliseconds;
+    auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
+    std::cout << "Sequential computing took: " << exec_time << " ms" << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     auto [desc, vm] = parallel::set_program_options(argc, argv, "Set the number of iterations");
@@ -17,8 +121,27 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (vm.count("hex-position"))
+    {
+        print_hex_digits(vm["hex-position"].as<std::size_t>(), vm["hex-digits"].as<std::size_t>());
+        return 0;
+    }
+
+    const auto engine = vm["engine"].as<std::string>();
+    if (engine != "bbp" && engine != "chudnovsky")
+    {
+        std::cout << "Unsupported engine. Abort" << std::endl;
+        return 1;
+    }
+
     std::size_t n_iterations;
-    if (vm.count("n-iterations"))
+    if (vm.count("digits"))
+    {
+        const auto digits = vm["digits"].as<std::size_t>();
+        n_iterations = (engine == "bbp") ? parallel::bbp_terms_for_digits(digits)
+                                         : parallel::chudnovsky_terms_for_digits(digits);
+    }
+    else if (vm.count("n-iterations"))
         n_iterations = vm["n-iterations"].as<std::size_t>();
     else
     {
@@ -26,18 +149,30 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    // the sum of the Chudnovsky series is the divisor of pi
+    if (engine == "chudnovsky" && n_iterations == 0)
+    {
+        std::cout << "The chudnovsky engine requires at least one iteration. Abort" << std::endl;
+        return 1;
+    }
 
-    auto pi = parallel::compute_pi(n_iterations);
+    if (vm.count("verify") && !vm.count("digits"))
+    {
+        std::cout << "Verification requires the number of digits. Abort" << std::endl;
+        return 1;
+    }
 
-    auto finish = std::chrono::high_resolution_clock::now();
+    const auto n_threads = vm["threads-per-rank"].as<unsigned>();
 
-    constexpr auto max_precision = std::numeric_limits<decltype(pi)>::max_digits10;
-    std::cout << std::setprecision(max_precision) << pi << std::endl;
+    auto start = std::chrono::high_resolution_clock::now();
 
-    using ms = std::chrono::milliseconds;
-    auto exec_time = std::chrono::duration_cast<ms>(finish - start).count();
-    std::cout << "Sequential computing took: " << exec_time << " ms" << std::endl;
+    bool verified;
+    if (engine == "bbp")
+        verified = print_pi(vm, parallel::bbp_binary_splitting(0, n_iterations, 1, n_threads),
+                            n_iterations, start);
+    else
+        verified = print_pi(vm, parallel::chudnovsky_binary_splitting(0, n_iterations, n_threads),
+                            n_iterations, start);
 
-    return 0;
+    return verified ? 0 : 1;
 }
@@ -0,0 +1,150 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "verification.hpp"
+#include "pi_computation.hpp"
+
+namespace parallel
+{
+
+namespace
+{
+
+// read-only mapping of a whole file
+class Mapped_File final
+{
+public:
+
+    explicit Mapped_File(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error{"Could not open file " + path};
+
+        struct stat info;
+        if (::fstat(fd, &info) == -1)
+        {
+            ::close(fd);
+            throw std::runtime_error{"Could not get the size of file " + path};
+        }
+
+        size_ = info.st_size;
+        if (size_ != 0)
+        {
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data_ == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error{"Could not map file " + path + " to memory"};
+            }
+
+            // the file is read once from the beginning to the end
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+
+        ::close(fd);
+    }
+
+    Mapped_File(const Mapped_File &) = delete;
+    Mapped_File &operator=(const Mapped_File &) = delete;
+
+    ~Mapped_File()
+    {
+        if (size_ != 0)
+            ::munmap(data_, size_);
+    }
+
+    std::string_view view() const noexcept
+    {
+        return std::string_view{static_cast<const char *>(data_), size_};
+    }
+
+private:
+
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // unnamed namespace
+
+bool verify_digits(std::ostream &os, const boost::multiprecision::cpp_int &scaled_pi,
+                   std::size_t digits, const std::string &reference_path)
+{
+    const Mapped_File file{reference_path};
+
+    std::string_view reference = file.view();
+    reference = reference.substr(0, reference.find_first_of(" \n\r\t"));
+
+    std::size_t position = 0;
+    std::size_t point = std::string_view::npos;
+    std::size_t mismatch = std::string_view::npos;
+    char computed = 0;
+
+    for_each_digit_chunk(scaled_pi, digits, [&](std::string_view chunk)
+    {
+        const auto expected = reference.substr(position, chunk.size());
+        const auto [computed_end, expected_end] = std::ranges::mismatch(chunk, expected);
+
+        if (computed_end != chunk.end() && expected_end != expected.end())
+        {
+            mismatch = position + (computed_end - chunk.begin());
+            computed = *computed_end;
+        }
+        else if (const auto dot = chunk.find('.'); dot != std::string_view::npos)
+            point = position + dot;
+
+        position += expected.size();
+
+        return mismatch == std::string_view::npos && position < reference.size();
+    });
+
+    if (point == std::string_view::npos)
+        point = reference.find('.');
+
+    // characters up to the point included are not decimal places
+    auto decimal_place = [point](std::size_t index) -> std::size_t
+    {
+        return (point == std::string_view::npos || index <= point) ? 0 : index - point;
+    };
+
+    if (mismatch != std::string_view::npos)
+    {
+        os << "Verification failed: the first mismatch with " << reference_path;
+        if (const auto place = decimal_place(mismatch))
+            os << " is at decimal place " << place;
+        else
+            os << " is in the integer part";
+        os << ": computed '" << computed << "', reference '" << reference[mismatch] << "'"
+           << std::endl;
+
+        return false;
+    }
+
+    // position is past the last compared character
+    const std::size_t n_verified = (position == 0) ? 0 : decimal_place(position - 1);
+    if (n_verified == 0)
+    {
+        os << "Verification failed: " << reference_path << " has no decimal places to compare"
+           << std::endl;
+
+        return false;
+    }
+
+    os << "Verification passed: " << n_verified << " decimal places match " << reference_path;
+    if (n_verified < digits)
+        os << " (the reference is shorter than the result)";
+    os << std::endl;
+
+    return true;
+}
+
+} // namespace parallel
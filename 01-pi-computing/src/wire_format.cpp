@@ -0,0 +1,83 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+#include "wire_format.hpp"
+
+namespace parallel
+{
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::limb_type;
+
+static_assert(sizeof(limb_type) == sizeof(std::uint64_t), "Limbs of cpp_int must be 64-bit");
+
+void encode(const cpp_int &x, Wire_Buffer &buffer)
+{
+    const auto &backend = x.backend();
+    const std::size_t n_limbs = backend.size();
+
+    buffer.push_back(backend.sign());
+    buffer.push_back(n_limbs);
+
+    const std::size_t position = buffer.size();
+    buffer.resize(position + n_limbs);
+    std::memcpy(buffer.data() + position, backend.limbs(), n_limbs * sizeof(limb_type));
+}
+
+void encode(const BBP_Sum &sum, Wire_Buffer &buffer)
+{
+    encode(sum.T, buffer);
+    encode(sum.Q, buffer);
+    buffer.push_back(sum.shift);
+}
+
+void encode(const Chudnovsky_Sum &sum, Wire_Buffer &buffer)
+{
+    encode(sum.P, buffer);
+    encode(sum.Q, buffer);
+    encode(sum.T, buffer);
+}
+
+static std::uint64_t read_word(std::span<const std::uint64_t> buffer, std::size_t &position)
+{
+    if (position >= buffer.size())
+        throw std::runtime_error{"Unexpected end of a message"};
+
+    return buffer[position++];
+}
+
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position, cpp_int &x)
+{
+    const bool negative = read_word(buffer, position);
+    const std::size_t n_limbs = read_word(buffer, position);
+
+    if (n_limbs == 0 || buffer.size() - position < n_limbs)
+        throw std::runtime_error{"Unexpected end of a message"};
+
+    auto &backend = x.backend();
+    backend.resize(n_limbs, n_limbs);
+    std::memcpy(backend.limbs(), buffer.data() + position, n_limbs * sizeof(limb_type));
+    backend.normalize();
+    backend.sign(negative);
+
+    position += n_limbs;
+}
+
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position, BBP_Sum &sum)
+{
+    decode(buffer, position, sum.T);
+    decode(buffer, position, sum.Q);
+    sum.shift = read_word(buffer, position);
+}
+
+void decode(std::span<const std::uint64_t> buffer, std::size_t &position, Chudnovsky_Sum &sum)
+{
+    decode(buffer, position, sum.P);
+    decode(buffer, position, sum.Q);
+    decode(buffer, position, sum.T);
+}
+
+} // namespace parallel
@@ -8,17 +8,20 @@ function usage()
     echo ""
     echo "-c <number-of-processes-to-run>"
     echo "-n <iterations-per-process>"
+    echo "-d <digits> (optional, 1000 by default)"
     exit 1
 }
 
 N_ARGS=$#
-if [ $N_ARGS -ne 4 ]; then # each option takes 2 command line arguments
-    usage "Script requires 2 options"
+if [ $N_ARGS -ne 4 ] && [ $N_ARGS -ne 6 ]; then # each option takes 2 command line arguments
+    usage "Script requires 2 or 3 options"
 fi
 
 NUM="^[0-9]+$"
 
-while getopts :c:n: OPT; do
+DIGITS=1000
+
+while getopts :c:n:d: OPT; do
     case $OPT in
     c) # -c <number-of-processes-to-run>
         N_PROC=$OPTARG
@@ -30,8 +33,14 @@ while getopts :c:n: OPT; do
         [[ $PER_PROC =~ $NUM ]] || usage "-n is followed not by a number"
         [[ $PER_PROC -gt 0 ]] || usage "-n is followed by a non-positive number"
 	    ;;
+	d) # -d <digits>
+	    DIGITS=$OPTARG
+        [[ $DIGITS =~ $NUM ]] || usage "-d is followed not by a number"
+	    ;;
 	*)
 	    usage "Invalid command line argument $OPTARG"
 	    ;;
   esac
 done
+
+[[ -n $N_PROC && -n $PER_PROC ]] || usage "Options -c and -n are required"
@@ -11,7 +11,7 @@ BUILD_DIR=$PROJECT_DIR/build
 function clean_up()
 {
     rm -rf $BUILD_DIR
-    rm -rf $SCRIPT_DIR/*.res
+    rm -rf $SCRIPT_DIR/*.res $SCRIPT_DIR/*.time
 }
 
 function build()
@@ -29,12 +29,12 @@ function run()
     local total=$((per_process * n_proc))
 
     echo -en "${green}Running sequential program...${default}"
-    $BUILD_DIR/sequential-pi --n-iterations $total > $SCRIPT_DIR/sequential.res
+    $BUILD_DIR/sequential --n-iterations $total > $SCRIPT_DIR/sequential.res
     SEQUENTIAL_TIME=$(tail -n 1 $SCRIPT_DIR/sequential.res | rev | cut -d' ' -f2 | rev)
     echo -en " $SEQUENTIAL_TIME ms\n\n"
 
     echo -en "${green}Running parallel program...${default}"
-    mpirun -c $n_proc $BUILD_DIR/parallel-pi --n-iterations $per_process > $SCRIPT_DIR/parallel.res
+    mpirun -c $n_proc $BUILD_DIR/parallel --n-iterations $per_process > $SCRIPT_DIR/parallel.res
     PARALLEL_TIME=$(tail -n 1 $SCRIPT_DIR/parallel.res | rev | cut -d' ' -f2 | rev)
     echo -en " $PARALLEL_TIME ms\n\n"
 }
@@ -52,9 +52,53 @@ function compare_results()
     fi
 }
 
+function exec_time()
+{
+    tail -n 1 $1 | rev | cut -d' ' -f2 | rev
+}
+
+function verify()
+{
+    local name=$1
+    local reference=$2
+    shift 2
+
+    echo -en "${green}Computing $name...${default}"
+    "$@" --verify $reference > $SCRIPT_DIR/$name.time
+    local status=$?
+    echo -en " $(exec_time $SCRIPT_DIR/$name.time) ms\n"
+
+    if [ $status -eq 0 ]
+    then
+        echo -e "${green}Test passed: $name matches sequential-bbp${default}"
+    else
+        echo -e "${red}Test failed: $(head -n 1 $SCRIPT_DIR/$name.time)${default}"
+    fi
+}
+
+function run_engines()
+{
+    local n_proc=$1
+    local digits=$2
+    local reference=$SCRIPT_DIR/sequential-bbp.res
+
+    echo -en "${green}Computing $digits digits by bbp engine sequentially...${default}"
+    $BUILD_DIR/sequential --engine bbp --digits $digits --output $reference \
+        > $SCRIPT_DIR/sequential-bbp.time
+    echo -en " $(exec_time $SCRIPT_DIR/sequential-bbp.time) ms\n\n"
+
+    verify parallel-bbp $reference \
+        mpirun -c $n_proc $BUILD_DIR/parallel --engine bbp --digits $digits
+    verify sequential-chudnovsky $reference \
+        $BUILD_DIR/sequential --engine chudnovsky --digits $digits
+    verify parallel-chudnovsky $reference \
+        mpirun -c $n_proc $BUILD_DIR/parallel --engine chudnovsky --digits $digits
+}
+
 source $SCRIPT_DIR/opts.sh
 
 clean_up
 build
 run $N_PROC $PER_PROC
 compare_results
+run_engines $N_PROC $DIGITS
@@ -0,0 +1,70 @@
+#ifndef INCLUDE_BENCHMARK_HPP
+#define INCLUDE_BENCHMARK_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <numbers>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+#include "sequential_solver.hpp"
+
+namespace parallel
+{
+
+/*
+ * The equation all benchmarks solve: a = 2, t and x in [0; 1], phi(x) = cos(pi x) and
+ * psi(t) = exp(-t). f is what benchmarks compare
+ */
+struct Benchmark_Equation final
+{
+    static constexpr double a = 2.0;
+    static constexpr double t_1 = 0.0;
+    static constexpr double t_2 = 1.0;
+    static constexpr double x_1 = 0.0;
+    static constexpr double x_2 = 1.0;
+
+    static double init_cond(double x) { return std::cos(std::numbers::pi * x); }
+    static double boundary_cond(double t) { return std::exp(-t); }
+};
+
+template<typename Layout, typename F>
+Transport_Equation_Solver<Layout, F> solve_benchmark_equation(std::size_t N_t, std::size_t N_x,
+                                                              F heterogeneity, Scheme scheme)
+{
+    using Equation = Benchmark_Equation;
+
+    return Transport_Equation_Solver<Layout, F>
+    {
+        Equation::a,
+        Equation::t_1, Equation::t_2, N_t,
+        Equation::x_1, Equation::x_2, N_x,
+        std::move(heterogeneity), Equation::init_cond, Equation::boundary_cond, scheme
+    };
+}
+
+using ms = std::chrono::duration<double, std::milli>;
+
+// the best time of n_runs calls of solve in milliseconds
+template<typename Solve>
+double best_time(std::size_t n_runs, Solve solve)
+{
+    double best = std::numeric_limits<double>::infinity();
+
+    for (auto i = 0uz; i != n_runs; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        solve();
+        auto finish = std::chrono::steady_clock::now();
+
+        best = std::min(best, ms{finish - start}.count());
+    }
+
+    return best;
+}
+
+} // namespace parallel
+
+#endif // INCLUDE_BENCHMARK_HPP
@@ -0,0 +1,77 @@
+#ifndef INCLUDE_F_TABLE_HPP
+#define INCLUDE_F_TABLE_HPP
+
+#include <cstddef>
+#include <algorithm>
+
+#include "grid.hpp"
+
+namespace parallel
+{
+
+/*
+ * Values of f(t, x) that schemes use on a grid of N_t x N_x points with steps tau and h starting
+ * from the point first_m: at nodes (t_k, x_m) and at centres of cells (t_k + tau / 2, x_m + h / 2)
+ * for k in [0; N_t - 1). A table is computed once and may be shared by any number of solvers of
+ * the same grid with F = const F_Table<Layout> &, which pays off when f is expensive. It takes
+ * twice as much memory as the grid, so it is not copyable, Layout should be the one of solvers
+ * and cannot be Rolling
+ */
+template<typename Layout = Space_Major>
+class F_Table final
+{
+    static_assert(!requires { Layout::n_layers; }, "A table keeps all time layers");
+
+public:
+
+    template<typename F>
+    F_Table(F f, std::size_t N_t, double t_step, std::size_t N_x, double x_step,
+            std::size_t first_m = 0)
+        : nodes_{N_t - 1, N_x}, centres_{N_t - 1, N_x}
+    {
+        const std::size_t n_steps = N_t - 1;
+
+        // bands of layers in the order solvers sweep them
+        for (auto band_first = 0uz; band_first != n_steps; )
+        {
+            const std::size_t band_last = band_first + std::min(Layout::sweep_steps,
+                                                                n_steps - band_first);
+
+            for (auto m = 0uz; m != N_x; ++m)
+            {
+                const double x = (first_m + m) * x_step;
+
+                for (auto k = band_first; k != band_last; ++k)
+                {
+                    const double t = k * t_step;
+
+                    nodes_[k, m] = f(t, x);
+                    centres_[k, m] = f(t + 0.5 * t_step, x + 0.5 * x_step);
+                }
+            }
+
+            band_first = band_last;
+        }
+    }
+
+    F_Table(const F_Table &rhs) = delete;
+    F_Table &operator=(const F_Table &rhs) = delete;
+
+    F_Table(F_Table &&rhs) = default;
+    F_Table &operator=(F_Table &&rhs) = default;
+
+    std::size_t t_size() const noexcept { return nodes_.t_size() + 1; }
+    std::size_t x_size() const noexcept { return nodes_.x_size(); }
+
+    double node(std::size_t k, std::size_t m) const { return nodes_[k, m]; }
+    double centre(std::size_t k, std::size_t m) const { return centres_[k, m]; }
+
+private:
+
+    Grid<Layout> nodes_;
+    Grid<Layout> centres_;
+};
+
+} // namespace parallel
+
+#endif // INCLUDE_F_TABLE_HPP
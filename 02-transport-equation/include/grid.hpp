@@ -2,30 +2,125 @@
 #define INCLUDE_GRID_HPP
 
 #include <cstddef>
+#include <limits>
+#include <algorithm>
 #include <vector>
 
 namespace parallel
 {
 
+/*
+ * Layouts of the grid in memory. index(k, m, N_t, N_x) is the position of the value on the time
+ * layer k at the point m, size(N_t, N_x) is the number of stored values. Solvers sweep the grid by
+ * bands of sweep_steps time layers (see Transport_Equation_Solver_Base::sweep), which is the
+ * order of increasing addresses for the layout
+ */
+
+// all time layers of a point are contiguous
+struct Space_Major final
+{
+    static constexpr std::size_t sweep_steps = std::numeric_limits<std::size_t>::max();
+
+    static std::size_t size(std::size_t N_t, std::size_t N_x) noexcept { return N_t * N_x; }
+
+    static std::size_t index(std::size_t k, std::size_t m, std::size_t N_t, std::size_t) noexcept
+    {
+        return m * N_t + k;
+    }
+};
+
+// all points of a time layer are contiguous
+struct Time_Major final
+{
+    static constexpr std::size_t sweep_steps = 1;
+
+    static std::size_t size(std::size_t N_t, std::size_t N_x) noexcept { return N_t * N_x; }
+
+    static std::size_t index(std::size_t k, std::size_t m, std::size_t, std::size_t N_x) noexcept
+    {
+        return k * N_x + m;
+    }
+};
+
+/*
+ * The grid is split into tiles of Tile_T time layers by Tile_X points. Tiles go band by band of
+ * Tile_T layers, and a tile stores its points one after another as Space_Major does, so a band
+ * is contiguous and so are values of a point within a tile. Edge tiles are padded
+ */
+template<std::size_t Tile_T = 64, std::size_t Tile_X = 64>
+struct Tiled final
+{
+    static_assert(Tile_T != 0 && Tile_X != 0);
+
+    static constexpr std::size_t sweep_steps = Tile_T;
+
+    static std::size_t size(std::size_t N_t, std::size_t N_x) noexcept
+    {
+        return n_tiles(N_t, Tile_T) * n_tiles(N_x, Tile_X) * Tile_T * Tile_X;
+    }
+
+    static std::size_t index(std::size_t k, std::size_t m, std::size_t, std::size_t N_x) noexcept
+    {
+        const std::size_t tile = k / Tile_T * n_tiles(N_x, Tile_X) + m / Tile_X;
+        return tile * Tile_T * Tile_X + m % Tile_X * Tile_T + k % Tile_T;
+    }
+
+private:
+
+    static std::size_t n_tiles(std::size_t n, std::size_t tile) noexcept
+    {
+        return (n + tile - 1) / tile;
+    }
+};
+
+/*
+ * Only the last Layers time layers are stored: the layer k takes the place of the layer
+ * k - Layers, so memory does not depend on N_t. Grids of this layout are swept layer by layer,
+ * and earlier layers are available only as snapshots taken by solvers
+ */
+template<std::size_t Layers = 2>
+struct Rolling final
+{
+    static_assert(Layers >= 2);
+
+    static constexpr std::size_t n_layers = Layers;
+    static constexpr std::size_t sweep_steps = 1;
+
+    static std::size_t size(std::size_t N_t, std::size_t N_x) noexcept
+    {
+        return std::min(N_t, Layers) * N_x;
+    }
+
+    static std::size_t index(std::size_t k, std::size_t m, std::size_t, std::size_t N_x) noexcept
+    {
+        return k % Layers * N_x + m;
+    }
+};
+
+template<typename Layout = Space_Major>
 class Grid final
 {
 public:
 
-    Grid(std::size_t N_t, std::size_t N_x) : storage_(N_t * N_x), N_t_{N_t}, N_x_{N_x} {}
+    using layout_type = Layout;
+
+    Grid(std::size_t N_t, std::size_t N_x)
+        : storage_(Layout::size(N_t, N_x)), N_t_{N_t}, N_x_{N_x} {}
 
     std::size_t t_size() const noexcept { return N_t_; }
     std::size_t x_size() const noexcept { return N_x_; }
 
+    // values in the order of the layout including padding
     const std::vector<double> &storage() const { return storage_; }
 
-    const double &operator[](std::size_t k, std::size_t m) const { return storage_[m * N_t_ + k]; }
-    double &operator[](std::size_t k, std::size_t m) { return storage_[m * N_t_ + k]; }
+    const double &operator[](std::size_t k, std::size_t m) const
+    {
+        return storage_[Layout::index(k, m, N_t_, N_x_)];
+    }
 
-    void swap(std::vector<double> &rhs, std::size_t N_t, std::size_t N_x)
+    double &operator[](std::size_t k, std::size_t m)
     {
-        storage_.swap(rhs);
-        N_t_ = N_t;
-        N_x_ = N_x;
+        return storage_[Layout::index(k, m, N_t_, N_x_)];
     }
 
 private:
@@ -4,31 +4,64 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cassert>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <functional>
 
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/request.hpp>
 
 #include "solver_base.hpp"
 
 namespace parallel
 {
 
-class Transport_Equation_PSolver final : public Transport_Equation_Solver_Base
+/*
+ * A node sweeps its points by blocks of time steps between messages. Tiled stores every band of
+ * Tile_T steps contiguously, so the sweep of a block goes through increasing addresses. With
+ * Rolling every node keeps two layers of its points, and the final grid of node 0 contains the
+ * last layers only. If snapshots are also taken (by every node), they are the result, and nodes
+ * keep their own points without gathering them on node 0
+ */
+template<typename Layout = Tiled<>, typename F = std::function<double(double, double)>>
+class Transport_Equation_PSolver final : public Transport_Equation_Solver_Base<Layout, F>
 {
+    using Base = Transport_Equation_Solver_Base<Layout, F>;
+
+    using Base::grid_;
+    using Base::a_;
+    using Base::tau_;
+    using Base::h_;
+    using Base::sweep;
+    using Base::solve_layers;
+    using Base::take_snapshot;
+    using Base::snapshots_;
+    using Base::implicit_left_corner;
+
 public:
 
-    using Transport_Equation_Solver_Base::two_arg_func;
-    using Transport_Equation_Solver_Base::one_arg_func;
-    using Transport_Equation_Solver_Base::Scheme;
+    using typename Base::two_arg_func;
+    using typename Base::one_arg_func;
+    using typename Base::Scheme;
 
+    /*
+     * phi and psi are called only here, so their types are always deduced. A table of f has to
+     * cover the points of this node
+     */
+    template<typename Phi = one_arg_func, typename Psi = one_arg_func>
     Transport_Equation_PSolver(const boost::mpi::communicator &world, double a,
                                double t_1, double t_2, std::size_t N_t,
                                double x_1, double x_2, std::size_t N_x,
-                               two_arg_func heterogeneity,
-                               one_arg_func init_cond, one_arg_func boundary_cond)
-        : Transport_Equation_Solver_Base{a, N_t, (t_2 - t_1) / (N_t - 1),
-                                         N_x / world.size(), (x_2 - x_1) / (N_x - 1),
-                                         heterogeneity}
+                               F heterogeneity, Phi init_cond, Psi boundary_cond,
+                               std::size_t block_steps = 0, Snapshots snapshots = {})
+        : Base{a, N_t, (t_2 - t_1) / (N_t - 1), N_x / world.size(), (x_2 - x_1) / (N_x - 1),
+               std::move(heterogeneity), std::move(snapshots), N_x / world.size() * world.rank()},
+          block_steps_{block_steps}
     {
         if (init_cond(x_1) != boundary_cond(t_1))
             throw std::invalid_argument{"Initial and boundary condition are not coordinated"};
@@ -41,110 +74,212 @@ public:
             for (auto i = 0uz; i != x_size; ++i)
                 grid_[0, i] = init_cond(x_1 + i * h_);
 
-            for (auto i = 1uz; i != t_size; ++i)
-                grid_[i, 0] = boundary_cond(t_1 + i * tau_);
-
-            solve_sequential(Scheme::implicit_left_corner);
+            this->solve_sequential(Scheme::implicit_left_corner,
+                                   [&](std::size_t k){ return boundary_cond(t_1 + k * tau_); });
         }
         else
         {
             const int rank = world.rank();
+            const double courant = a_ * tau_ / h_;
+
+            // calibration computes the first layers, which may take the place of the initial one
+            if (block_steps_ == 0)
+                block_steps_ = tune_block_steps(world, courant);
+            block_steps_ = std::min(block_steps_, t_size - 1);
 
             for (auto start_i = x_size * rank, i = 0uz; i != x_size; ++i)
                 grid_[0, i] = init_cond((start_i + i) * h_);
 
-            const double courant = a_ * tau_ / h_;
+            solve_pipelined(world, courant,
+                            [&](std::size_t k){ return boundary_cond(t_1 + k * tau_); });
+
+            if constexpr (requires { Layout::n_layers; })
+                if (snapshots_.sink)
+                    return;
+
+            const auto &storage = grid_.storage();
 
             if (rank == 0)
             {
-                for (auto i = 1uz; i != t_size; ++i)
-                    grid_[i, 0] = boundary_cond(t_1 + i * tau_);
+                std::vector<double> parts;
+                parts.reserve(storage.size() * w_size);
 
-                solve_left_border(world, courant);
+                boost::mpi::gather(world, storage.data(), storage.size(), parts, 0);
 
-                std::vector<double> full_grid;
-                full_grid.reserve(t_size * x_size * w_size);
+                // storages of nodes are concatenated, which is not the layout of the full grid
+                std::size_t first_k = 0;
+                if constexpr (requires { Layout::n_layers; })
+                    first_k = t_size - std::min(t_size, Layout::n_layers);
 
-                boost::mpi::gather(world, &grid_[0, 0], t_size * x_size, full_grid, 0);
-                grid_.swap(full_grid, t_size, x_size * w_size);
-            }
-            else
-            {
-                if (rank == w_size - 1)
-                    solve_right_border(world, courant);
-                else
-                    solve_middle(world, courant);
+                Grid<Layout> full_grid{t_size, x_size * w_size};
+                for (auto r = 0uz; r != static_cast<std::size_t>(w_size); ++r)
+                {
+                    const double *part = parts.data() + r * storage.size();
+
+                    sweep(Layout::sweep_steps, first_k, t_size, 0, x_size,
+                          [&](std::size_t k, std::size_t m)
+                    {
+                        full_grid[k, r * x_size + m] = part[Layout::index(k, m, t_size, x_size)];
+                    });
+                }
 
-                boost::mpi::gather(world, &grid_[0, 0], t_size * x_size, 0);
+                grid_ = std::move(full_grid);
             }
+            else
+                boost::mpi::gather(world, storage.data(), storage.size(), 0);
         }
     }
 
+    // the number of time steps every node computes between messages
+    std::size_t block_steps() const noexcept { return block_steps_; }
+
 private:
 
-    void solve_left_border(const boost::mpi::communicator &world, double courant)
+    static constexpr std::size_t n_latency_round_trips = 100;
+    static constexpr std::size_t n_calibration_steps = 16;
+
+    /*
+     * A pipeline of P nodes computing N steps by blocks of K steps takes about
+     * (N / K + P - 1) * (K * step_time + latency), which is minimal for
+     * K = sqrt(N * latency / ((P - 1) * step_time)). Latency is measured by ping-pong between
+     * nodes 0 and 1, and step time by computing the first steps of node 0 that are computed
+     * again by the pipeline
+     */
+    std::size_t tune_block_steps(const boost::mpi::communicator &world, double courant)
     {
-        assert(world.rank() == 0);
-
         constexpr int tag = 0;
-        constexpr int next_node_rank = 1;
-        const std::size_t N_x = grid_.x_size();
-        const std::size_t N_t = grid_.t_size();
+        using seconds = std::chrono::duration<double>;
+
+        const int rank = world.rank();
+        const std::size_t n_steps = grid_.t_size() - 1;
+
+        std::size_t block_steps = 1;
 
-        for (auto k = 0uz; k != N_t - 1; ++k)
+        if (rank == 0)
         {
-            for (auto m = 1uz; m != N_x; ++m)
-                implicit_left_corner(courant, k, m);
+            double token = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (auto i = 0uz; i != n_latency_round_trips; ++i)
+            {
+                world.send(1, tag, token);
+                world.recv(1, tag, token);
+            }
+            auto finish = std::chrono::steady_clock::now();
+
+            const double latency = seconds{finish - start}.count() / (2 * n_latency_round_trips);
+
+            const std::size_t n_timed = std::min(n_calibration_steps, n_steps);
+
+            start = std::chrono::steady_clock::now();
+            sweep(Layout::sweep_steps, 0, n_timed, 1, grid_.x_size(),
+                  [&](std::size_t k, std::size_t m){ implicit_left_corner(courant, k, m); });
+            finish = std::chrono::steady_clock::now();
 
-            world.send(next_node_rank, tag, grid_[k + 1, N_x - 1]);
+            const double step_time = seconds{finish - start}.count() / n_timed;
+
+            const double optimum = std::sqrt(n_steps * latency
+                                             / ((world.size() - 1) * std::max(step_time, 1e-9)));
+            block_steps = std::clamp<std::size_t>(std::llround(optimum), 1, n_steps);
+        }
+        else if (rank == 1)
+        {
+            double token;
+            for (auto i = 0uz; i != n_latency_round_trips; ++i)
+            {
+                world.recv(0, tag, token);
+                world.send(0, tag, token);
+            }
         }
+
+        boost::mpi::broadcast(world, block_steps, 0);
+
+        return block_steps;
     }
 
-    void solve_middle(const boost::mpi::communicator &world, double courant)
+    /*
+     * Every node computes blocks of block_steps_ time steps for all its points and sends values of
+     * its last point on these steps to the next node in one non-blocking message. Values from the
+     * previous node are received in two buffers: the next block is received while the current one
+     * is computed. Sent values are copied to two buffers as well, since they are contiguous in
+     * the grid only for Space_Major. boundary(k) is the value on the layer k at the point 0 of
+     * node 0
+     */
+    template<typename Boundary>
+    void solve_pipelined(const boost::mpi::communicator &world, double courant, Boundary boundary)
     {
-        assert(0 < world.rank() && world.rank() < world.size() - 1);
-
         constexpr int tag = 0;
         const int rank = world.rank();
+        const bool has_previous = rank != 0;
+        const bool has_next = rank != world.size() - 1;
         const std::size_t N_x = grid_.x_size();
-        const std::size_t N_t = grid_.t_size();
+        const std::size_t n_steps = grid_.t_size() - 1;
+        const std::size_t n_blocks = (n_steps + block_steps_ - 1) / block_steps_;
+        const std::size_t first_m = N_x * rank;
 
-        double leftmost;
+        std::array<std::vector<double>, 2> leftmost;
+        std::array<std::vector<double>, 2> rightmost;
+        std::array<boost::mpi::request, 2> receives;
+        std::array<boost::mpi::request, 2> sends;
 
-        for (auto k = 0uz; k != N_t - 1; ++k)
+        auto receive_block = [&](std::size_t block)
         {
-            world.recv(rank - 1, tag, leftmost);
+            const std::size_t first = block * block_steps_;
+            auto &buffer = leftmost[block % 2];
 
-            implicit_left_corner(courant, k, 0, leftmost);
+            buffer.resize(std::min(block_steps_, n_steps - first));
+            receives[block % 2] = world.irecv(rank - 1, tag, buffer.data(), buffer.size());
+        };
 
-            for (auto m = 1uz; m != N_x; ++m)
-                implicit_left_corner(courant, k, m);
+        if (has_previous)
+            receive_block(0);
 
-            world.send(rank + 1, tag, grid_[k + 1, N_x - 1]);
-        }
-    }
+        take_snapshot(0, first_m);
 
-    void solve_right_border(const boost::mpi::communicator &world, double courant)
-    {
-        assert(world.rank() == world.size() - 1);
+        for (auto block = 0uz; block != n_blocks; ++block)
+        {
+            const std::size_t first = block * block_steps_;
+            const std::size_t last = std::min(first + block_steps_, n_steps);
 
-        constexpr int tag = 0;
-        const int rank = world.rank();
-        const std::size_t N_x = grid_.x_size();
-        const std::size_t N_t = grid_.t_size();
+            if (has_previous)
+            {
+                if (block + 1 != n_blocks)
+                    receive_block(block + 1);
 
-        double leftmost;
+                receives[block % 2].wait();
+            }
 
-        for (auto k = 0uz; k != N_t - 1; ++k)
-        {
-            world.recv(rank - 1, tag, leftmost);
+            if (has_next && block >= 2)
+                sends[block % 2].wait();
 
-            implicit_left_corner(courant, k, 0, leftmost);
+            const auto &received = leftmost[block % 2];
+            auto &to_send = rightmost[block % 2];
+            to_send.resize(last - first);
 
-            for (auto m = 1uz; m != N_x; ++m)
-                implicit_left_corner(courant, k, m);
+            solve_layers(Layout::sweep_steps, first, last, [&](std::size_t k)
+            {
+                if (has_previous)
+                    implicit_left_corner(courant, k, 0, received[k - first]);
+                else
+                    grid_[k + 1, 0] = boundary(k + 1);
+            },
+            [&](std::size_t k, std::size_t m){ implicit_left_corner(courant, k, m); },
+            [&](std::size_t k)
+            {
+                to_send[k - 1 - first] = grid_[k, N_x - 1];
+                take_snapshot(k, first_m);
+            });
+
+            if (has_next)
+                sends[block % 2] = world.isend(rank + 1, tag, to_send.data(), to_send.size());
         }
+
+        if (has_next)
+            for (auto block = (n_blocks > 2) ? n_blocks - 2 : 0; block != n_blocks; ++block)
+                sends[block % 2].wait();
     }
+
+    std::size_t block_steps_;
 };
 
 } // namespace parallel
@@ -3,29 +3,44 @@
 
 #include <cstddef>
 #include <stdexcept>
+#include <utility>
+#include <functional>
 
 #include "solver_base.hpp"
 
 namespace parallel
 {
 
-class Transport_Equation_Solver final : public Transport_Equation_Solver_Base
+/*
+ * Schemes that use only the previous point sweep the grid in the order of Layout, so any layout
+ * works for them and Space_Major keeps a point on all layers in the cache. Explicit three points
+ * is always solved layer by layer and suits Time_Major. Rolling keeps two layers only, and the
+ * solution is passed to the sink of snapshots
+ */
+template<typename Layout = Space_Major, typename F = std::function<double(double, double)>>
+class Transport_Equation_Solver final : public Transport_Equation_Solver_Base<Layout, F>
 {
+    using Base = Transport_Equation_Solver_Base<Layout, F>;
+
+    using Base::grid_;
+    using Base::tau_;
+    using Base::h_;
+
 public:
 
-    using Transport_Equation_Solver_Base::two_arg_func;
-    using Transport_Equation_Solver_Base::one_arg_func;
-    using Transport_Equation_Solver_Base::Scheme;
+    using typename Base::two_arg_func;
+    using typename Base::one_arg_func;
+    using typename Base::Scheme;
 
+    // phi and psi are called only here, so their types are always deduced
+    template<typename Phi = one_arg_func, typename Psi = one_arg_func>
     Transport_Equation_Solver(double a,
                               double t_1, double t_2, std::size_t N_t,
                               double x_1, double x_2, std::size_t N_x,
-                              two_arg_func heterogeneity,
-                              one_arg_func init_cond, one_arg_func boundary_cond,
-                              Scheme scheme)
-        : Transport_Equation_Solver_Base{a,
-                                         N_t, (t_2 - t_1) / (N_t - 1), N_x, (x_2 - x_1) / (N_x - 1),
-                                         heterogeneity}
+                              F heterogeneity, Phi init_cond, Psi boundary_cond,
+                              Scheme scheme, Snapshots snapshots = {})
+        : Base{a, N_t, (t_2 - t_1) / (N_t - 1), N_x, (x_2 - x_1) / (N_x - 1),
+               std::move(heterogeneity), std::move(snapshots)}
     {
         if (init_cond(x_1) != boundary_cond(t_1))
             throw std::invalid_argument{"Initial and boundary condition are not coordinated"};
@@ -33,10 +48,7 @@ public:
         for (auto i = 0; i != grid_.x_size(); ++i)
             grid_[0, i] = init_cond(x_1 + i * h_);
 
-        for (auto i = 1; i != grid_.t_size(); ++i)
-            grid_[i, 0] = boundary_cond(t_1 + i * tau_);
-
-        solve_sequential(scheme);
+        this->solve_sequential(scheme, [&](std::size_t k){ return boundary_cond(t_1 + k * tau_); });
     }
 };
 
@@ -0,0 +1,88 @@
+#ifndef INCLUDE_SNAPSHOT_WRITER_HPP
+#define INCLUDE_SNAPSHOT_WRITER_HPP
+
+#include <cstddef>
+#include <string>
+#include <span>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace parallel
+{
+
+/*
+ * Writes snapshots selected as in Snapshots to a binary file: N_x doubles of every selected layer
+ * in order of increasing k. Parts of a layer are written at their offsets as soon as they come,
+ * so every node of the parallel solver may write its own points into the same file
+ */
+class Snapshot_Writer final
+{
+public:
+
+    Snapshot_Writer(const std::string &path, std::size_t N_t, std::size_t N_x, std::size_t every)
+        : N_t_{N_t}, N_x_{N_x}, every_{every}
+    {
+        // every node opens the file, so it is not truncated but resized to its final size
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd_ == -1)
+            throw std::runtime_error{"Could not open file " + path};
+
+        if (::ftruncate(fd_, n_snapshots() * N_x_ * sizeof(double)) == -1)
+        {
+            ::close(fd_);
+            throw std::runtime_error{"Could not resize file " + path};
+        }
+    }
+
+    Snapshot_Writer(const Snapshot_Writer &rhs) = delete;
+    Snapshot_Writer &operator=(const Snapshot_Writer &rhs) = delete;
+
+    ~Snapshot_Writer() { ::close(fd_); }
+
+    std::size_t n_snapshots() const noexcept
+    {
+        if (every_ == 0)
+            return 1;
+
+        const std::size_t n_steps = N_t_ - 1;
+        return n_steps / every_ + 1 + (n_steps % every_ != 0);
+    }
+
+    void operator()(std::size_t k, std::size_t first_m, std::span<const double> values) const
+    {
+        const std::size_t offset = (slot(k) * N_x_ + first_m) * sizeof(double);
+        const std::size_t size = values.size_bytes();
+
+        const char *data = reinterpret_cast<const char *>(values.data());
+        for (std::size_t written = 0; written != size; )
+        {
+            const ssize_t n = ::pwrite(fd_, data + written, size - written, offset + written);
+            if (n == -1)
+                throw std::runtime_error{"Could not write a snapshot"};
+
+            written += n;
+        }
+    }
+
+private:
+
+    // only the final layer may be selected besides multiples of every
+    std::size_t slot(std::size_t k) const noexcept
+    {
+        if (every_ == 0)
+            return 0;
+
+        return k / every_ + (k % every_ != 0);
+    }
+
+    int fd_;
+    std::size_t N_t_;
+    std::size_t N_x_;
+    std::size_t every_;
+};
+
+} // namespace parallel
+
+#endif // INCLUDE_SNAPSHOT_WRITER_HPP
@@ -1,17 +1,34 @@
 #ifndef INCLUDE_SOLUTION_VISUALIZATION
 #define INCLUDE_SOLUTION_VISUALIZATION
 
+#include <cstddef>
 #include <string_view>
 #include <functional>
-
-#include "solver_base.hpp"
+#include <vector>
 
 namespace parallel
 {
 
-void plot_solution(const Transport_Equation_Solver_Base &solution, std::string_view heterogeneity,
+// u[k][m] is the numerical solution on the time layer k at the point m
+void plot_solution(const std::vector<std::vector<double>> &u, double t_step, double x_step,
+                   double parameter, std::string_view heterogeneity,
                    std::function<double(double, double)> analytical_solution);
 
+// Solution is a solver of any layout
+template<typename Solution>
+void plot_solution(const Solution &solution, std::string_view heterogeneity,
+                   std::function<double(double, double)> analytical_solution)
+{
+    std::vector<std::vector<double>> u(solution.t_size(), std::vector<double>(solution.x_size()));
+
+    for (auto k = 0uz; k != solution.t_size(); ++k)
+        for (auto m = 0uz; m != solution.x_size(); ++m)
+            u[k][m] = solution[k, m];
+
+    plot_solution(u, solution.t_step(), solution.x_step(), solution.parameter(), heterogeneity,
+                  analytical_solution);
+}
+
 } // namespace parallel
 
 #endif // INCLUDE_SOLUTION_VISUALIZATION
@@ -6,6 +6,10 @@
 #include <cmath>
 #include <cassert>
 #include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <span>
+#include <vector>
 
 #include "grid.hpp"
 
@@ -17,12 +21,37 @@ struct unstable_scheme : public std::runtime_error
     unstable_scheme() : std::runtime_error{"The scheme is unstable for given parameters"} {}
 };
 
+enum class Scheme
+{
+    implicit_left_corner,
+    explicit_three_points,
+    explicit_left_corner,
+    rectangle
+};
+
+/*
+ * Selected time layers of the solution: sink(k, first_m, values) receives values of the layer k
+ * at points [first_m; first_m + values.size()). Every node of the parallel solver passes its own
+ * points. Layers 0, every, 2 * every, ... and the final one are selected, every = 0 selects only
+ * the final layer
+ */
+struct Snapshots
+{
+    std::function<void(std::size_t, std::size_t, std::span<const double>)> sink;
+    std::size_t every = 0;
+};
+
 /*
  * Solves equation:
  * du/dt + a * du/dx = f(t, x), where u = u(t, x), x in (0; X), t in (0; T), a in R
  * u(0, x) = phi(x), x in [0; X]
  * u(t, 0) = psi(t), t in [0; T]
+ *
+ * F is the type of f. With a lambda or another callable class kernels inline f, std::function
+ * (the default) accepts f known at runtime only. F may also be an F_Table of the same grid or a
+ * const reference to it
  */
+template<typename Layout, typename F = std::function<double(double, double)>>
 class Transport_Equation_Solver_Base
 {
 protected:
@@ -34,8 +63,9 @@ public:
 
     Transport_Equation_Solver_Base(double a,
                                    std::size_t N_t, double t_step, std::size_t N_x, double x_step,
-                                   two_arg_func heterogeneity)
-        : grid_{N_t, N_x}, a_{a}, tau_{t_step}, h_{x_step}, f_{heterogeneity}
+                                   F heterogeneity, Snapshots snapshots, std::size_t first_m = 0)
+        : grid_{N_t, N_x}, a_{a}, tau_{t_step}, h_{x_step}, f_{std::move(heterogeneity)},
+          first_m_{first_m}, snapshots_{std::move(snapshots)}
     {
         if (t_step < 0)
             throw std::invalid_argument{"Left time boundary must be less then right boundary"};
@@ -45,8 +75,13 @@ public:
             throw std::invalid_argument{"The number of segments on the T axis must be at least 2"};
         else if (N_x < 2)
             throw std::invalid_argument{"The number of segments on the X axis must be at least 2"};
+
+        if constexpr (tabulated)
+            if (f_.t_size() != N_t || f_.x_size() != N_x)
+                throw std::invalid_argument{"The table of f does not match the grid"};
     }
 
+    // only the last layers are kept in grids of the Rolling layout
     const double &operator[](std::size_t k, std::size_t m) const { return grid_[k, m]; }
 
     std::size_t x_size() const noexcept { return grid_.x_size(); }
@@ -57,21 +92,96 @@ public:
 
     double parameter() const noexcept { return a_; }
 
-    enum class Scheme
-    {
-        implicit_left_corner,
-        explicit_three_points,
-        explicit_left_corner,
-        rectangle
-    };
+    using Scheme = parallel::Scheme;
 
 protected:
 
     ~Transport_Equation_Solver_Base() = default;
 
-    void solve_sequential(Scheme scheme)
+    /*
+     * Calls step(k, m) for k in [first_k; last_k) and m in [first_m; last_m) by bands of
+     * band_steps time layers aligned to multiples of band_steps: every band is swept point by
+     * point. A single layer and the whole time axis are bands too
+     */
+    template<typename Step>
+    static void sweep(std::size_t band_steps, std::size_t first_k, std::size_t last_k,
+                      std::size_t first_m, std::size_t last_m, Step step)
+    {
+        for (auto band_first = first_k; band_first < last_k; )
+        {
+            const std::size_t band_last = std::min((band_first / band_steps + 1) * band_steps,
+                                                   last_k);
+
+            for (auto m = first_m; m < last_m; ++m)
+                for (auto k = band_first; k != band_last; ++k)
+                    step(k, m);
+
+            band_first = band_last;
+        }
+    }
+
+    /*
+     * Computes layers first_k + 1, ..., last_k by bands of sweep(): for every step k of a band
+     * left(k) computes the point 0 on the layer k + 1, then step(k, m) computes the other points
+     * and done(k + 1) is called for all layers of the band. Any band fits schemes that use only
+     * the previous point, explicit three points needs bands of one layer. Grids of the Rolling
+     * layout are swept by single layers, so done() sees a layer before it is overwritten
+     */
+    template<typename Left, typename Step, typename Done>
+    void solve_layers(std::size_t band_steps, std::size_t first_k, std::size_t last_k,
+                      Left left, Step step, Done done)
+    {
+        for (auto band_first = first_k; band_first < last_k; )
+        {
+            const std::size_t band_last = std::min((band_first / band_steps + 1) * band_steps,
+                                                   last_k);
+
+            for (auto k = band_first; k != band_last; ++k)
+                left(k);
+
+            sweep(band_steps, band_first, band_last, 1, grid_.x_size(), step);
+
+            for (auto k = band_first; k != band_last; ++k)
+                done(k + 1);
+
+            band_first = band_last;
+        }
+    }
+
+    bool is_snapshot(std::size_t k) const noexcept
+    {
+        return snapshots_.sink && (k == grid_.t_size() - 1 ||
+                                   (snapshots_.every != 0 && k % snapshots_.every == 0));
+    }
+
+    // passes the layer k to the sink of snapshots if it is selected
+    void take_snapshot(std::size_t k, std::size_t first_m)
+    {
+        if (!is_snapshot(k))
+            return;
+
+        layer_.resize(grid_.x_size());
+        for (auto m = 0uz; m != grid_.x_size(); ++m)
+            layer_[m] = grid_[k, m];
+
+        snapshots_.sink(k, first_m, layer_);
+    }
+
+    /*
+     * The initial layer has to be set. boundary(k) is the value on the layer k at the point 0
+     */
+    template<typename Boundary>
+    void solve_sequential(Scheme scheme, Boundary boundary)
     {
         const double courant = a_ * tau_ / h_;
+        const std::size_t n_steps = grid_.t_size() - 1;
+        const std::size_t N_x = grid_.x_size();
+        const std::size_t band_steps = Layout::sweep_steps;
+
+        auto left = [&](std::size_t k){ grid_[k + 1, 0] = boundary(k + 1); };
+        auto done = [&](std::size_t k){ take_snapshot(k, 0); };
+
+        take_snapshot(0, 0);
 
         switch (scheme)
         {
@@ -80,9 +190,10 @@ protected:
                 if (courant > -1 && courant < 0)
                     throw unstable_scheme{};
 
-                for (auto m = 1uz; m != grid_.x_size(); ++m)
-                    for (auto k = 0uz; k != grid_.t_size() - 1; ++k)
-                        implicit_left_corner(courant, k, m);
+                solve_layers(band_steps, 0, n_steps, left, [&](std::size_t k, std::size_t m)
+                {
+                    implicit_left_corner(courant, k, m);
+                }, done);
 
                 break;
 
@@ -91,9 +202,10 @@ protected:
                 if (courant < 0 || courant > 1)
                     throw unstable_scheme{};
 
-                for (auto m = 1uz; m != grid_.x_size(); ++m)
-                    for (auto k = 0uz; k != grid_.t_size() - 1; ++k)
-                        explicit_left_corner(courant, k, m);
+                solve_layers(band_steps, 0, n_steps, left, [&](std::size_t k, std::size_t m)
+                {
+                    explicit_left_corner(courant, k, m);
+                }, done);
 
                 break;
 
@@ -101,9 +213,10 @@ protected:
 
                 // unconditionally stable
 
-                for (auto m = 1uz; m != grid_.x_size(); ++m)
-                    for (auto k = 0uz; k != grid_.t_size() - 1; ++k)
-                        rectangle(courant, k, m);
+                solve_layers(band_steps, 0, n_steps, left, [&](std::size_t k, std::size_t m)
+                {
+                    rectangle(courant, k, m);
+                }, done);
 
                 break;
 
@@ -112,12 +225,14 @@ protected:
                 if (std::abs(courant) > 1)
                     throw unstable_scheme{};
 
-                for (auto m = 1uz; m != grid_.x_size() - 1; ++m)
-                    for (auto k = 0uz; k != grid_.t_size() - 1; ++k)
+                // the next layer needs the right neighbour on the current one
+                solve_layers(1, 0, n_steps, left, [&](std::size_t k, std::size_t m)
+                {
+                    if (m != N_x - 1)
                         explicit_three_points(courant, k, m);
-
-                for (auto k = 0uz; k != grid_.t_size() - 1; ++k)
-                    rectangle(courant, k, grid_.x_size() - 1);
+                    else
+                        rectangle(courant, k, m);
+                }, done);
 
                 break;
 
@@ -126,6 +241,26 @@ protected:
         }
     }
 
+    static constexpr bool tabulated = requires (const F &f) { f.node(0uz, 0uz); };
+
+    // f on the layer k at the point m
+    double f_node(std::size_t k, std::size_t m) const
+    {
+        if constexpr (tabulated)
+            return f_.node(k, m);
+        else
+            return f_(k * tau_, (first_m_ + m) * h_);
+    }
+
+    // f in the centre of the cell between layers k, k + 1 and points m, m + 1
+    double f_centre(std::size_t k, std::size_t m) const
+    {
+        if constexpr (tabulated)
+            return f_.centre(k, m);
+        else
+            return f_(k * tau_ + 0.5 * tau_, (first_m_ + m) * h_ + 0.5 * h_);
+    }
+
     /*
      *      +
      *      |
@@ -136,7 +271,7 @@ protected:
         assert(0 <= courant && courant <= 1); // stability condition
 
         grid_[k + 1, m] = (1 - courant) * grid_[k, m] + courant * grid_[k, m - 1]
-                        + tau_ * f_(k * tau_, m * h_);
+                        + tau_ * f_node(k, m);
     }
 
     /*
@@ -151,10 +286,10 @@ protected:
 
     void implicit_left_corner(double courant, std::size_t k, std::size_t m, double leftmost)
     {
-        assert(courant => 0 || courant <= -1); // stability condition
+        assert(courant >= 0 || courant <= -1); // stability condition
 
         grid_[k + 1, m] = (grid_[k, m] + courant * leftmost
-                                       + tau_ * f_(k * tau_, m * h_)) / (1 + courant);
+                                       + tau_ * f_node(k, m)) / (1 + courant);
     }
 
     /*
@@ -167,7 +302,7 @@ protected:
         assert(std::abs(courant) <= 1); // stability condition
 
         grid_[k + 1, m] = 0.5 * ((1 - courant) * grid_[k, m + 1] +
-                                 (1 + courant) * grid_[k, m - 1]) + tau_ * f_(k * tau_, m * h_);
+                                 (1 + courant) * grid_[k, m - 1]) + tau_ * f_node(k, m);
     }
 
     /*
@@ -177,17 +312,20 @@ protected:
      */
     void rectangle(double courant, std::size_t k, std::size_t m)
     {
-        const double f = f_(k * tau_ + 0.5 * tau_, m * h_ + 0.5 * h_);
+        const double f = f_centre(k, m);
 
         grid_[k + 1, m] = ((grid_[k, m] - grid_[k + 1, m - 1]) * (1 - courant)
                         + 2 * tau_ * f) / (1 + courant) + grid_[k, m - 1];
     }
 
-    Grid grid_;
+    Grid<Layout> grid_;
     double a_;
     double tau_;
     double h_;
-    two_arg_func f_;
+    F f_;
+    std::size_t first_m_; // the global index of the point 0
+    Snapshots snapshots_;
+    std::vector<double> layer_;
 };
 
 } // namespace parallel
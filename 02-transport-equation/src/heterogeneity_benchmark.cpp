@@ -0,0 +1,152 @@
+#include <cmath>
+#include <numbers>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <boost/program_options.hpp>
+
+#include "f_table.hpp"
+#include "benchmark.hpp"
+
+/*
+ * Solves the equation with f passed through std::function, as a lambda that kernels inline and as
+ * a table computed once for all runs. Every scheme uses its default layout. Prints the best time
+ * of several runs and the time of computing the table
+ */
+
+using Scheme = parallel::Scheme;
+using parallel::best_time;
+using parallel::ms;
+
+// f is passed by reference, so a table is not copied. The sum of the final layer tells whether
+// all variants computed the same
+template<typename Layout, typename F>
+static double solve(std::size_t N_t, std::size_t N_x, Scheme scheme, const F &heterogeneity)
+{
+    auto solution = parallel::solve_benchmark_equation<Layout, const F &>(N_t, N_x, heterogeneity,
+                                                                         scheme);
+
+    double sum = 0;
+    for (auto m = 0uz; m != N_x; ++m)
+        sum += solution[N_t - 1, m];
+
+    return sum;
+}
+
+template<typename Layout, typename F>
+static void compare(std::string_view name, std::size_t N_t, std::size_t N_x, Scheme scheme,
+                    std::size_t n_runs, F heterogeneity)
+{
+    const std::function<double(double, double)> erased = heterogeneity;
+
+    double sums[3] = {};
+    double times[4] = {};
+
+    times[0] = best_time(n_runs, [&]{ sums[0] = solve<Layout>(N_t, N_x, scheme, erased); });
+    times[1] = best_time(n_runs, [&]{ sums[1] = solve<Layout>(N_t, N_x, scheme, heterogeneity); });
+
+    auto start = std::chrono::steady_clock::now();
+    const parallel::F_Table<Layout> table{heterogeneity,
+                                          N_t, 1.0 / (N_t - 1), N_x, 1.0 / (N_x - 1)};
+    auto finish = std::chrono::steady_clock::now();
+    times[3] = ms{finish - start}.count();
+
+    times[2] = best_time(n_runs, [&]{ sums[2] = solve<Layout>(N_t, N_x, scheme, table); });
+
+    std::cout << std::setw(44) << name << std::fixed << std::setprecision(1);
+    for (auto time : times)
+        std::cout << ' ' << std::setw(14) << time;
+
+    if (sums[0] != sums[1] || sums[0] != sums[2])
+        std::cout << "  results differ";
+    std::cout << std::endl;
+}
+
+template<typename F>
+static void compare_schemes(std::string_view f_name, std::size_t N_t, std::size_t N_x,
+                            std::size_t n_runs, F heterogeneity)
+{
+    constexpr std::pair<Scheme, std::string_view> schemes[] = {
+        {Scheme::implicit_left_corner, "implicit-left-corner"},
+        {Scheme::explicit_left_corner, "explicit-left-corner"},
+        {Scheme::explicit_three_points, "explicit-three-points"},
+        {Scheme::rectangle, "rectangle"}
+    };
+
+    for (auto [scheme, scheme_name] : schemes)
+    {
+        const std::string name = std::string{scheme_name} + ", f = " + std::string{f_name};
+
+        try
+        {
+            if (scheme == Scheme::explicit_three_points)
+                compare<parallel::Time_Major>(name, N_t, N_x, scheme, n_runs, heterogeneity);
+            else
+                compare<parallel::Space_Major>(name, N_t, N_x, scheme, n_runs, heterogeneity);
+        }
+        catch (const parallel::unstable_scheme &)
+        {
+            std::cout << std::setw(44) << name << " unstable for this grid" << std::endl;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    po::options_description desc{"Allowed options"};
+    desc.add_options()
+        ("help", "Produce help message")
+        ("t-dots", po::value<std::size_t>()->default_value(8192),
+         "Set the number of points on T axis of the grid")
+        ("x-dots", po::value<std::size_t>()->default_value(4096),
+         "Set the number of points on X axis of the grid")
+        ("runs", po::value<std::size_t>()->default_value(3),
+         "Set the number of runs of every measurement");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto N_t = vm["t-dots"].as<std::size_t>();
+    const auto N_x = vm["x-dots"].as<std::size_t>();
+    const auto n_runs = vm["runs"].as<std::size_t>();
+
+    if (N_t < 2 || N_x < 2)
+    {
+        std::cout << "The grid must have at least 2 points on each axis. Abort" << std::endl;
+        return 0;
+    }
+
+    if (n_runs == 0)
+    {
+        std::cout << "The number of runs must be positive. Abort" << std::endl;
+        return 0;
+    }
+
+    std::cout << "Best time of " << n_runs << " runs on the grid of " << N_t << " x " << N_x
+              << " points, ms:" << std::endl;
+    std::cout << std::setw(44) << "solver" << std::setw(15) << "std::function"
+              << std::setw(15) << "inlined" << std::setw(15) << "table"
+              << std::setw(15) << "making table" << std::endl;
+
+    compare_schemes("x + t", N_t, N_x, n_runs, [](double t, double x){ return x + t; });
+    compare_schemes("exp(-t) sin(pi x)", N_t, N_x, n_runs, [](double t, double x)
+    {
+        return std::exp(-t) * std::sin(std::numbers::pi * x);
+    });
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <iterator>
+#include <utility>
+#include <string>
+#include <string_view>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/program_options.hpp>
+
+#include "parallel_solver.hpp"
+#include "benchmark.hpp"
+
+/*
+ * Solves the equation on the same grid with every layout of the grid in memory and prints
+ * the best time of several runs. Default layouts of the solvers are marked with '*'
+ */
+
+using Scheme = parallel::Scheme;
+using Equation = parallel::Benchmark_Equation;
+
+template<typename Layout>
+static double time_sequential(std::size_t N_t, std::size_t N_x, Scheme scheme, std::size_t n_runs)
+{
+    auto heterogeneity = [](double t, double x){ return x + t; };
+
+    return parallel::best_time(n_runs, [&]
+    {
+        auto solution = parallel::solve_benchmark_equation<Layout>(N_t, N_x, heterogeneity, scheme);
+    });
+}
+
+template<typename Layout>
+static double time_parallel(const boost::mpi::communicator &world,
+                            std::size_t N_t, std::size_t N_x, std::size_t n_runs)
+{
+    auto heterogeneity = [](double t, double x){ return x + t; };
+
+    return parallel::best_time(n_runs, [&]
+    {
+        world.barrier();
+
+        parallel::Transport_Equation_PSolver<Layout, decltype(heterogeneity)> solution
+        {
+            world, Equation::a,
+            Equation::t_1, Equation::t_2, N_t,
+            Equation::x_1, Equation::x_2, N_x,
+            heterogeneity, Equation::init_cond, Equation::boundary_cond
+        };
+    });
+}
+
+static void print_row(std::string_view name, const double (&times)[3], std::size_t default_i)
+{
+    std::cout << std::setw(24) << name << std::fixed << std::setprecision(1);
+    for (auto i = 0uz; i != std::size(times); ++i)
+        std::cout << ' ' << std::setw(13) << times[i] << ((i == default_i) ? '*' : ' ');
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    boost::mpi::environment env{argc, argv};
+    boost::mpi::communicator world;
+
+    po::options_description desc{"Allowed options"};
+    desc.add_options()
+        ("help", "Produce help message")
+        ("t-dots", po::value<std::size_t>()->default_value(8192),
+         "Set the number of points on T axis of the grid")
+        ("x-dots", po::value<std::size_t>()->default_value(4096),
+         "Set the number of points on X axis of the grid (divided between processes by the "
+         "parallel solver)")
+        ("runs", po::value<std::size_t>()->default_value(3),
+         "Set the number of runs of every measurement");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        if (world.rank() == 0)
+            std::cout << desc << std::endl;
+
+        return 0;
+    }
+
+    const auto N_t = vm["t-dots"].as<std::size_t>();
+    const auto N_x = vm["x-dots"].as<std::size_t>();
+    const auto n_runs = vm["runs"].as<std::size_t>();
+
+    if (N_x < 2uz * world.size())
+    {
+        if (world.rank() == 0)
+            std::cout << "Every process needs at least 2 points on X axis. Abort" << std::endl;
+
+        return 0;
+    }
+
+    if (world.rank() == 0)
+    {
+        std::cout << "Best time of " << n_runs << " runs on the grid of " << N_t << " x " << N_x
+                  << " points, ms:" << std::endl;
+        std::cout << std::setw(24) << "solver" << std::setw(15) << "space-major"
+                  << std::setw(15) << "time-major" << std::setw(15) << "tiled" << std::endl;
+
+        constexpr std::pair<Scheme, std::string_view> schemes[] = {
+            {Scheme::implicit_left_corner, "implicit-left-corner"},
+            {Scheme::explicit_left_corner, "explicit-left-corner"},
+            {Scheme::explicit_three_points, "explicit-three-points"},
+            {Scheme::rectangle, "rectangle"}
+        };
+
+        for (auto [scheme, name] : schemes)
+        {
+            try
+            {
+                const double times[] = {
+                    time_sequential<parallel::Space_Major>(N_t, N_x, scheme, n_runs),
+                    time_sequential<parallel::Time_Major>(N_t, N_x, scheme, n_runs),
+                    time_sequential<parallel::Tiled<>>(N_t, N_x, scheme, n_runs)
+                };
+
+                print_row(name, times, (scheme == Scheme::explicit_three_points) ? 1 : 0);
+            }
+            catch (const parallel::unstable_scheme &)
+            {
+                std::cout << std::setw(24) << name << " unstable for this grid" << std::endl;
+            }
+        }
+    }
+
+    const double times[] = {
+        time_parallel<parallel::Space_Major>(world, N_t, N_x, n_runs),
+        time_parallel<parallel::Time_Major>(world, N_t, N_x, n_runs),
+        time_parallel<parallel::Tiled<>>(world, N_t, N_x, n_runs)
+    };
+
+    if (world.rank() == 0)
+        print_row("parallel on " + std::to_string(world.size())
+                  + ((world.size() > 1) ? " nodes" : " node"), times, 2);
+
+    return 0;
+}
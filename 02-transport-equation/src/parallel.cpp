@@ -4,17 +4,21 @@
 #include <iostream>
 #include <optional>
 #include <tuple>
+#include <string>
+#include <functional>
 
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/program_options.hpp>
 
 #include "parallel_solver.hpp"
+#include "snapshot_writer.hpp"
 #include "solution_visualization.hpp"
 #include "analytical_solution.hpp"
 
 static auto get_options(int argc, char *argv[], const boost::mpi::communicator &world)
-    -> std::optional<std::tuple<std::size_t, std::size_t, bool>>
+    -> std::optional<std::tuple<std::size_t, std::size_t, std::size_t, bool, bool, std::string,
+                                std::size_t>>
 {
     namespace po = boost::program_options;
 
@@ -24,7 +28,17 @@ static auto get_options(int argc, char *argv[], const boost::mpi::communicator &
         ("t-dots", po::value<std::size_t>(), "Set the number of points on T axis of the grid.")
         ("x-dots-per-process", po::value<std::size_t>(),
          "Set the number of points on X axis of the grid for each process")
-        ("plot", "Plot solution");
+        ("block-steps", po::value<std::size_t>()->default_value(0),
+         "Set the number of time steps each process computes before sending its boundary values "
+         "to the next one (0 chooses it by measured latency)")
+        ("plot", "Plot solution")
+        ("rolling", "Keep only two time layers in memory of every process; earlier layers are "
+                    "available as snapshots only")
+        ("snapshots", po::value<std::string>(),
+         "Set the binary file to write snapshots of the solution to")
+        ("snapshot-every", po::value<std::size_t>()->default_value(0),
+         "Write time layers 0, S, 2S, ... and the final one to the file of snapshots (0 means "
+         "only the final layer)");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -60,32 +74,63 @@ static auto get_options(int argc, char *argv[], const boost::mpi::communicator &
         return std::nullopt;
     }
 
+    const auto block_steps = vm["block-steps"].as<std::size_t>();
+
     bool plot = vm.count("plot");
+    bool rolling = vm.count("rolling");
+
+    if (plot && rolling)
+    {
+        if (world.rank() == 0)
+            std::cout << "Plotting needs all time layers, which are not kept with --rolling. Abort"
+                      << std::endl;
+
+        return std::nullopt;
+    }
+
+    std::string snapshot_file;
+    if (vm.count("snapshots"))
+        snapshot_file = vm["snapshots"].as<std::string>();
+    else if (!vm["snapshot-every"].defaulted())
+    {
+        if (world.rank() == 0)
+            std::cout << "The file of snapshots is not set. Abort" << std::endl;
 
-    return std::tuple{N_t, N_x, plot};
+        return std::nullopt;
+    }
+
+    const auto snapshot_every = vm["snapshot-every"].as<std::size_t>();
+
+    return std::tuple{N_t, N_x, block_steps, plot, rolling, snapshot_file, snapshot_every};
 }
 
-int main(int argc, char *argv[])
+template<typename Layout>
+static void solve(const boost::mpi::communicator &world, std::size_t N_t, std::size_t N_x,
+                  std::size_t block_steps, bool plot,
+                  const std::string &snapshot_file, std::size_t snapshot_every)
 {
-    boost::mpi::environment env{argc, argv};
-    boost::mpi::communicator world;
+    std::optional<parallel::Snapshot_Writer> writer;
+    parallel::Snapshots snapshots;
 
-    auto opts = get_options(argc, argv, world);
-    if (!opts.has_value())
-        return 0;
+    if (!snapshot_file.empty())
+    {
+        writer.emplace(snapshot_file, N_t, N_x, snapshot_every);
+        snapshots = {std::ref(*writer), snapshot_every};
+    }
 
-    auto [N_t, N_x, plot] = opts.value();
+    auto heterogeneity = [](double t, double x){ return x + t; };
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    parallel::Transport_Equation_PSolver solution
+    parallel::Transport_Equation_PSolver<Layout, decltype(heterogeneity)> solution
     {
         world, 2.0 /* a */,
         0.0 /* t_1 */, 1.0 /* T */, N_t /* N_t */,
         0.0 /* x_1 */, 1.0 /* X */, N_x /* N_x */,
-        [](double t, double x){ return x + t; },
+        heterogeneity,
         [](double x){ return std::cos(std::numbers::pi * x); },
-        [](double t){ return std::exp(-t); }
+        [](double t){ return std::exp(-t); },
+        block_steps, snapshots
     };
 
     auto stop = std::chrono::high_resolution_clock::now();
@@ -97,9 +142,35 @@ int main(int argc, char *argv[])
                   << ((world.size() > 1) ? " nodes" : " node") << " took: "
                   << std::chrono::duration_cast<mcs>(stop - start).count() << " mcs" << std::endl;
 
+        if (world.size() > 1)
+            std::cout << "Time steps per message: " << solution.block_steps() << std::endl;
+
+        if (writer.has_value())
+            std::cout << writer->n_snapshots() << " time layers of " << N_x
+                      << " points are written to " << snapshot_file << std::endl;
+
         if (plot)
             plot_solution(solution, "x + t", parallel::analytical_solution);
     }
+}
+
+int main(int argc, char *argv[])
+{
+    boost::mpi::environment env{argc, argv};
+    boost::mpi::communicator world;
+
+    auto opts = get_options(argc, argv, world);
+    if (!opts.has_value())
+        return 0;
+
+    auto [N_t, N_x, block_steps, plot, rolling, snapshot_file, snapshot_every] = opts.value();
+
+    if (rolling)
+        solve<parallel::Rolling<>>(world, N_t, N_x, block_steps, plot,
+                                   snapshot_file, snapshot_every);
+    else
+        solve<parallel::Tiled<>>(world, N_t, N_x, block_steps, plot,
+                                 snapshot_file, snapshot_every);
 
     return 0;
 }
@@ -5,17 +5,20 @@
 #include <optional>
 #include <tuple>
 #include <string>
+#include <functional>
 
 #include <boost/program_options.hpp>
 
 #include "sequential_solver.hpp"
+#include "snapshot_writer.hpp"
 #include "solution_visualization.hpp"
 #include "analytical_solution.hpp"
 
-using Scheme = parallel::Transport_Equation_Solver_Base::Scheme;
+using Scheme = parallel::Scheme;
 
 static auto get_options(int argc, char *argv[])
-    -> std::optional<std::tuple<std::size_t, std::size_t, Scheme, bool>>
+    -> std::optional<std::tuple<std::size_t, std::size_t, Scheme, bool, bool, std::string,
+                                std::size_t>>
 {
     namespace po = boost::program_options;
 
@@ -29,7 +32,14 @@ static auto get_options(int argc, char *argv[])
                                              "  - explicit-left-corner;\n"
                                              "  - explicit-tree-points;\n"
                                              "  - rectangle")
-        ("plot", "Plot solution");
+        ("plot", "Plot solution")
+        ("rolling", "Keep only two time layers in memory; earlier layers are available as "
+                    "snapshots only")
+        ("snapshots", po::value<std::string>(),
+         "Set the binary file to write snapshots of the solution to")
+        ("snapshot-every", po::value<std::size_t>()->default_value(0),
+         "Write time layers 0, S, 2S, ... and the final one to the file of snapshots (0 means "
+         "only the final layer)");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -83,29 +93,55 @@ static auto get_options(int argc, char *argv[])
     }
 
     bool plot = vm.count("plot");
+    bool rolling = vm.count("rolling");
 
-    return std::tuple{N_t, N_x, scheme, plot};
+    if (plot && rolling)
+    {
+        std::cout << "Plotting needs all time layers, which are not kept with --rolling. Abort"
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    std::string snapshot_file;
+    if (vm.count("snapshots"))
+        snapshot_file = vm["snapshots"].as<std::string>();
+    else if (!vm["snapshot-every"].defaulted())
+    {
+        std::cout << "The file of snapshots is not set. Abort" << std::endl;
+        return std::nullopt;
+    }
+
+    const auto snapshot_every = vm["snapshot-every"].as<std::size_t>();
+
+    return std::tuple{N_t, N_x, scheme, plot, rolling, snapshot_file, snapshot_every};
 }
 
-int main(int argc, char *argv[])
+template<typename Layout>
+static void solve(std::size_t N_t, std::size_t N_x, Scheme scheme, bool plot,
+                  const std::string &snapshot_file, std::size_t snapshot_every)
 {
-    auto opts = get_options(argc, argv);
-    if (!opts.has_value())
-        return 0;
+    std::optional<parallel::Snapshot_Writer> writer;
+    parallel::Snapshots snapshots;
 
-    auto [N_t, N_x, scheme, plot] = opts.value();
+    if (!snapshot_file.empty())
+    {
+        writer.emplace(snapshot_file, N_t, N_x, snapshot_every);
+        snapshots = {std::ref(*writer), snapshot_every};
+    }
+
+    auto heterogeneity = [](double t, double x){ return x + t; };
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    parallel::Transport_Equation_Solver solution
+    parallel::Transport_Equation_Solver<Layout, decltype(heterogeneity)> solution
     {
         2.0 /* a */,
         0.0 /* t_1 */, 1.0 /* t_2 */, N_t /* N_t */,
         0.0 /* x_1 */, 1.0 /* x_2 */, N_x /* N_x */,
-        [](double t, double x){ return x + t; },
+        heterogeneity,
         [](double x){ return std::cos(std::numbers::pi * x); },
         [](double t){ return std::exp(-t); },
-        scheme
+        scheme, snapshots
     };
 
     auto stop = std::chrono::high_resolution_clock::now();
@@ -114,8 +150,28 @@ int main(int argc, char *argv[])
     std::cout << "Sequential solving took: "
               << std::chrono::duration_cast<mcs>(stop - start).count() << " mcs" << std::endl;
 
+    if (writer.has_value())
+        std::cout << writer->n_snapshots() << " time layers of " << N_x << " points are written to "
+                  << snapshot_file << std::endl;
+
     if (plot)
         parallel::plot_solution(solution, "x + t", parallel::analytical_solution);
+}
+
+int main(int argc, char *argv[])
+{
+    auto opts = get_options(argc, argv);
+    if (!opts.has_value())
+        return 0;
+
+    auto [N_t, N_x, scheme, plot, rolling, snapshot_file, snapshot_every] = opts.value();
+
+    if (rolling)
+        solve<parallel::Rolling<>>(N_t, N_x, scheme, plot, snapshot_file, snapshot_every);
+    else if (scheme == Scheme::explicit_three_points)
+        solve<parallel::Time_Major>(N_t, N_x, scheme, plot, snapshot_file, snapshot_every);
+    else
+        solve<parallel::Space_Major>(N_t, N_x, scheme, plot, snapshot_file, snapshot_every);
 
     return 0;
 }
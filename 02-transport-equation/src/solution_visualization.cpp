@@ -4,39 +4,42 @@
 
 #include <matplot/matplot.h>
 
-#include "solver_base.hpp"
+#include "solution_visualization.hpp"
 
 namespace parallel
 {
 
-void plot_solution(const Transport_Equation_Solver_Base &solution, std::string_view heterogeneity,
+void plot_solution(const std::vector<std::vector<double>> &u_numerical, double t_step,
+                   double x_step, double parameter, std::string_view heterogeneity,
                    std::function<double(double, double)> analytical_solution)
 {
-    double T = (solution.t_size() - 1) * solution.t_step();
-    double X = (solution.x_size() - 1) * solution.x_step();
+    const std::size_t t_size = u_numerical.size();
+    const std::size_t x_size = u_numerical.front().size();
 
-    auto [x, t] = matplot::meshgrid(matplot::linspace(0.0, X, solution.x_size()),
-                                    matplot::linspace(0.0, T, solution.t_size()));
+    double T = (t_size - 1) * t_step;
+    double X = (x_size - 1) * x_step;
 
-    std::vector<std::vector<double>> u(solution.t_size());
-    auto u_numerical = u, delta_u = u;
+    auto [x, t] = matplot::meshgrid(matplot::linspace(0.0, X, x_size),
+                                    matplot::linspace(0.0, T, t_size));
 
-    for (auto k = 0; k != solution.t_size(); ++k)
+    std::vector<std::vector<double>> u(t_size);
+    auto delta_u = u;
+
+    for (auto k = 0uz; k != t_size; ++k)
     {
-        for (auto m = 0; m != solution.x_size(); ++m)
+        for (auto m = 0uz; m != x_size; ++m)
         {
-            double numerical_value = solution[k, m];
-            double value = analytical_solution(k * solution.t_step(), m * solution.x_step());
+            double numerical_value = u_numerical[k][m];
+            double value = analytical_solution(k * t_step, m * x_step);
 
             u[k].push_back(value);
-            u_numerical[k].push_back(numerical_value);
             delta_u[k].push_back(std::abs(value - numerical_value));
         }
     }
 
     matplot::sgtitle(std::format("du/dt {} {:.2f} * du/x = {}; t in [0; {:.2f}], x in [0; {:.2f}]",
-                                 solution.parameter() > 0 ? '+' : '-',
-                                 std::abs(solution.parameter()), heterogeneity, T, X));
+                                 parameter > 0 ? '+' : '-',
+                                 std::abs(parameter), heterogeneity, T, X));
 
     matplot::subplot(1, 3, 0);
     matplot::surf(x, t, u_numerical);